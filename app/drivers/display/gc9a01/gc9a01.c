@@ -14,11 +14,18 @@
 #include <zephyr/pm/pm.h>
 #include <zephyr/pm/device.h>
 #include <zephyr/pm/policy.h>
+#include <zephyr/linker/section_tags.h>
 
 LOG_MODULE_REGISTER(gc9a01, CONFIG_DISPLAY_LOG_LEVEL);
 
 #define GC9A01_SPI_PROFILING
 
+#ifdef CONFIG_GC9A01_RAMFUNC
+#define GC9A01_RAMFUNC __ramfunc
+#else
+#define GC9A01_RAMFUNC
+#endif
+
 /**
  * gc9a01 display controller driver.
  *
@@ -166,8 +173,87 @@ struct gc9a01_frame {
 
 static struct gc9a01_frame frame = {{0, 0}, {DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1}};
 
-static inline int gc9a01_write_cmd(const struct device *dev, uint8_t cmd,
-                                   const uint8_t *data, size_t len)
+static void gc9a01_bus_autosuspend(struct k_work *work);
+
+/**
+ * The SPI bus is resumed on first use and only suspended after it has been
+ * unused for CONFIG_GC9A01_BUS_AUTOSUSPEND_DELAY_MS, instead of around every
+ * single write.
+ */
+struct gc9a01_bus_pm {
+    const struct device *bus;
+    uint32_t users;
+    bool resumed;
+    uint32_t transfers;
+    uint32_t transitions;
+};
+
+static struct gc9a01_bus_pm bus_pm = {
+    .bus = DEVICE_DT_GET(DT_INST_BUS(0)),
+};
+
+K_MUTEX_DEFINE(bus_pm_lock);
+K_WORK_DELAYABLE_DEFINE(bus_suspend_work, gc9a01_bus_autosuspend);
+
+static int gc9a01_bus_get(void)
+{
+    int rc = 0;
+
+    k_mutex_lock(&bus_pm_lock, K_FOREVER);
+    k_work_cancel_delayable(&bus_suspend_work);
+    if (!bus_pm.resumed) {
+        rc = pm_device_action_run(bus_pm.bus, PM_DEVICE_ACTION_RESUME);
+        if (rc == 0 || rc == -EALREADY) {
+            rc = 0;
+            bus_pm.resumed = true;
+            bus_pm.transitions++;
+        } else {
+            LOG_ERR("Failed resume SPI Bus: %d", rc);
+        }
+    }
+    if (rc == 0) {
+        bus_pm.users++;
+        bus_pm.transfers++;
+    }
+    k_mutex_unlock(&bus_pm_lock);
+
+    return rc;
+}
+
+static void gc9a01_bus_put(k_timeout_t delay)
+{
+    k_mutex_lock(&bus_pm_lock, K_FOREVER);
+    __ASSERT(bus_pm.users > 0, "Unbalanced SPI bus put");
+    bus_pm.users--;
+    if (bus_pm.users == 0) {
+        k_work_reschedule(&bus_suspend_work, delay);
+    }
+    k_mutex_unlock(&bus_pm_lock);
+}
+
+static void gc9a01_bus_autosuspend(struct k_work *work)
+{
+    int rc;
+
+    k_mutex_lock(&bus_pm_lock, K_FOREVER);
+    // A new transfer may have started while waiting for the lock.
+    if (bus_pm.resumed && bus_pm.users == 0) {
+        rc = pm_device_action_run(bus_pm.bus, PM_DEVICE_ACTION_SUSPEND);
+        if (rc == 0 || rc == -EALREADY) {
+            bus_pm.resumed = false;
+            bus_pm.transitions++;
+            LOG_DBG("SPI bus suspended after %d transfers, %d transitions total", bus_pm.transfers,
+                    bus_pm.transitions);
+            bus_pm.transfers = 0;
+        } else {
+            LOG_ERR("Failed suspend SPI Bus: %d", rc);
+        }
+    }
+    k_mutex_unlock(&bus_pm_lock);
+}
+
+static inline GC9A01_RAMFUNC int gc9a01_write_cmd(const struct device *dev, uint8_t cmd,
+                                                  const uint8_t *data, size_t len)
 {
     const struct gc9a01_config *config = dev->config;
     struct spi_buf buf = {.buf = &cmd, .len = sizeof(cmd)};
@@ -191,7 +277,7 @@ static inline int gc9a01_write_cmd(const struct device *dev, uint8_t cmd,
     return 0;
 }
 
-static void gc9a01_set_frame(const struct device *dev, struct gc9a01_frame frame)
+static GC9A01_RAMFUNC void gc9a01_set_frame(const struct device *dev, struct gc9a01_frame frame)
 {
     uint8_t data[4];
 
@@ -210,20 +296,39 @@ static void gc9a01_set_frame(const struct device *dev, struct gc9a01_frame frame
 
 static int gc9a01_blanking_off(const struct device *dev)
 {
-    return gc9a01_write_cmd(dev, GC9A01A_DISPON, NULL, 0);
+    int rc;
+
+    rc = gc9a01_bus_get();
+    if (rc != 0) {
+        return rc;
+    }
+    rc = gc9a01_write_cmd(dev, GC9A01A_DISPON, NULL, 0);
+    gc9a01_bus_put(K_MSEC(CONFIG_GC9A01_BUS_AUTOSUSPEND_DELAY_MS));
+
+    return rc;
 }
 
 static int gc9a01_blanking_on(const struct device *dev)
 {
-    return gc9a01_write_cmd(dev, GC9A01A_DISPOFF, NULL, 0);
+    int rc;
+
+    rc = gc9a01_bus_get();
+    if (rc != 0) {
+        return rc;
+    }
+    rc = gc9a01_write_cmd(dev, GC9A01A_DISPOFF, NULL, 0);
+    gc9a01_bus_put(K_MSEC(CONFIG_GC9A01_BUS_AUTOSUSPEND_DELAY_MS));
+
+    return rc;
 }
 
-static int gc9a01_write(const struct device *dev, const uint16_t x, const uint16_t y,
-                        const struct display_buffer_descriptor *desc,
-                        const void *buf)
+static GC9A01_RAMFUNC int gc9a01_write(const struct device *dev, const uint16_t x, const uint16_t y,
+                                       const struct display_buffer_descriptor *desc,
+                                       const void *buf)
 {
-    const struct gc9a01_config *config = dev->config;
-    __ASSERT(pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_RESUME) == 0, "Failed resume SPI Bus");
+    if (gc9a01_bus_get() != 0) {
+        return -EIO;
+    }
 #ifdef GC9A01_SPI_PROFILING
     uint32_t start_time;
     uint32_t stop_time;
@@ -252,7 +357,7 @@ static int gc9a01_write(const struct device *dev, const uint16_t x, const uint16
     nanoseconds_spent = k_cyc_to_ns_ceil32(cycles_spent);
     LOG_DBG("%d =>: %dns", len, nanoseconds_spent);
 #endif
-    __ASSERT(pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_SUSPEND) == 0, "Failed suspend SPI Bus");
+    gc9a01_bus_put(K_MSEC(CONFIG_GC9A01_BUS_AUTOSUSPEND_DELAY_MS));
     return 0;
 }
 
@@ -317,8 +422,10 @@ static int gc9a01_controller_init(const struct device *dev)
     k_msleep(5);
     gpio_pin_set_dt(&config->reset_gpio, 1);
     k_msleep(150);
-    rc = pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_RESUME);
-    __ASSERT(rc == -EALREADY || rc == 0, "Failed resume SPI Bus");
+    rc = gc9a01_bus_get();
+    if (rc != 0) {
+        return rc;
+    }
 
     uint8_t cmd, x, numArgs;
     int i = 0;
@@ -334,7 +441,7 @@ static int gc9a01_controller_init(const struct device *dev)
         i++;
     }
 
-    __ASSERT(pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_SUSPEND) == 0, "Failed suspend SPI Bus");
+    gc9a01_bus_put(K_MSEC(CONFIG_GC9A01_BUS_AUTOSUSPEND_DELAY_MS));
     return 0;
 }
 
@@ -369,8 +476,11 @@ static int gc9a01_pm_action(const struct device *dev,
                             enum pm_device_action action)
 {
     int err = 0;
-    const struct gc9a01_config *config = dev->config;
-    __ASSERT(pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_RESUME) == 0, "Failed resume SPI Bus");
+
+    err = gc9a01_bus_get();
+    if (err != 0) {
+        return err;
+    }
 
     switch (action) {
         case PM_DEVICE_ACTION_RESUME:
@@ -391,12 +501,8 @@ static int gc9a01_pm_action(const struct device *dev,
             err = -ENOTSUP;
     }
 
-    err = pm_device_action_run(config->bus.bus, PM_DEVICE_ACTION_SUSPEND);
-    __ASSERT(err == 0 || err == -EALREADY, "Failed suspend SPI Bus");
-
-    if (err == -EALREADY) {
-        err = 0;
-    }
+    // No more frames are coming when the display is suspended, release the bus right away.
+    gc9a01_bus_put(action == PM_DEVICE_ACTION_RESUME ? K_MSEC(CONFIG_GC9A01_BUS_AUTOSUSPEND_DELAY_MS) : K_NO_WAIT);
 
     if (err < 0) {
         LOG_ERR("%s: failed to set power mode", dev->name);
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 Jakob Krantz <mail@jakobkrantz.se>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT hynitron_cst816s
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/logging/log.h>
+
+#include "emul_cst816s.h"
+
+LOG_MODULE_REGISTER(emul_cst816s, CONFIG_INPUT_LOG_LEVEL);
+
+#define CST816S_REG_CHIP_ID             0xA7
+#define CST816S_CHIP_ID                 0xB4
+
+struct cst816s_emul_data {
+	uint8_t regs[256];
+	uint8_t cur_reg;
+	uint32_t num_reads;
+	uint32_t num_writes;
+	bool unresponsive;
+};
+
+static int cst816s_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+	struct cst816s_emul_data *data = target->data;
+
+	if (data->unresponsive) {
+		return -EIO;
+	}
+
+	for (int i = 0; i < num_msgs; i++) {
+		if (msgs[i].flags & I2C_MSG_READ) {
+			for (uint32_t j = 0; j < msgs[i].len; j++) {
+				msgs[i].buf[j] = data->regs[data->cur_reg++];
+			}
+			data->num_reads++;
+			continue;
+		}
+
+		if (msgs[i].len == 0) {
+			continue;
+		}
+
+		/* First byte written selects the register, the rest is data. */
+		data->cur_reg = msgs[i].buf[0];
+		for (uint32_t j = 1; j < msgs[i].len; j++) {
+			data->regs[data->cur_reg++] = msgs[i].buf[j];
+		}
+		if (msgs[i].len > 1) {
+			data->num_writes++;
+		}
+	}
+
+	return 0;
+}
+
+uint32_t cst816s_emul_get_num_reads(const struct emul *target)
+{
+	struct cst816s_emul_data *data = target->data;
+
+	return data->num_reads;
+}
+
+uint32_t cst816s_emul_get_num_writes(const struct emul *target)
+{
+	struct cst816s_emul_data *data = target->data;
+
+	return data->num_writes;
+}
+
+void cst816s_emul_reset_counters(const struct emul *target)
+{
+	struct cst816s_emul_data *data = target->data;
+
+	data->num_reads = 0;
+	data->num_writes = 0;
+}
+
+uint8_t cst816s_emul_get_reg(const struct emul *target, uint8_t reg)
+{
+	struct cst816s_emul_data *data = target->data;
+
+	return data->regs[reg];
+}
+
+void cst816s_emul_set_unresponsive(const struct emul *target, bool unresponsive)
+{
+	struct cst816s_emul_data *data = target->data;
+
+	data->unresponsive = unresponsive;
+}
+
+static const struct i2c_emul_api cst816s_emul_api = {
+	.transfer = cst816s_emul_transfer,
+};
+
+static int cst816s_emul_init(const struct emul *target, const struct device *parent)
+{
+	struct cst816s_emul_data *data = target->data;
+
+	ARG_UNUSED(parent);
+
+	data->regs[CST816S_REG_CHIP_ID] = CST816S_CHIP_ID;
+
+	return 0;
+}
+
+#define CST816S_EMUL_DEFINE(index)                                                                  \
+	static struct cst816s_emul_data cst816s_emul_data_##index;                                      \
+	EMUL_DT_INST_DEFINE(index, cst816s_emul_init, &cst816s_emul_data_##index, NULL,                  \
+			    &cst816s_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(CST816S_EMUL_DEFINE)
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2023 Jakob Krantz <mail@jakobkrantz.se>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZSW_DRIVERS_INPUT_EMUL_CST816S_H_
+#define ZSW_DRIVERS_INPUT_EMUL_CST816S_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/drivers/emul.h>
+
+/* Number of I2C read and write transfers made since the last reset of the counters. */
+uint32_t cst816s_emul_get_num_reads(const struct emul *target);
+uint32_t cst816s_emul_get_num_writes(const struct emul *target);
+void cst816s_emul_reset_counters(const struct emul *target);
+
+uint8_t cst816s_emul_get_reg(const struct emul *target, uint8_t reg);
+
+/* Make every transfer fail with -EIO, as a chip that does not answer. */
+void cst816s_emul_set_unresponsive(const struct emul *target, bool unresponsive);
+
+#endif /* ZSW_DRIVERS_INPUT_EMUL_CST816S_H_ */
@@ -73,6 +73,8 @@
 
 #define CST816S_RESET_DELAY             5  /* in ms */
 #define CST816S_WAIT_DELAY              50 /* in ms */
+/* Configuration attempts after resume, the delay doubles for each. */
+#define CST816S_RESUME_RETRIES          4
 
 #define CST816S_GESTURE_NONE            0x00
 #define CST816S_GESTURE_UP_SLIDING      0x01
@@ -100,6 +102,13 @@ struct cst816s_config {
 struct cst816s_data {
 	const struct device *dev;
 	struct k_work work;
+	/* Finishes chip configuration after the reset pulse on resume. */
+	struct k_work_delayable resume_work;
+	struct k_work_sync work_sync;
+	uint8_t resume_retries;
+	bool suspended;
+	/* Interrupts/timer events that still arrived while suspended, should stay 0. */
+	uint32_t suspended_events;
 
 #ifdef CONFIG_INPUT_CST816S_INTERRUPT
 	struct gpio_callback int_gpio_cb;
@@ -188,6 +197,11 @@ static void cst816s_work_handler(struct k_work *work)
 {
 	struct cst816s_data *data = CONTAINER_OF(work, struct cst816s_data, work);
 
+	if (data->suspended) {
+		data->suspended_events++;
+		return;
+	}
+
 	cst816s_process(data->dev);
 }
 
@@ -207,6 +221,17 @@ static void cst816s_timer_handler(struct k_timer *timer)
 }
 #endif
 
+static void cst816s_reset_pulse(const struct device *dev)
+{
+	const struct cst816s_config *config = dev->config;
+
+	if (gpio_is_ready_dt(&config->rst_gpio)) {
+		gpio_pin_set_dt(&config->rst_gpio, 1);
+		k_msleep(CST816S_RESET_DELAY);
+		gpio_pin_set_dt(&config->rst_gpio, 0);
+	}
+}
+
 static void cst816s_chip_reset(const struct device *dev)
 {
 	const struct cst816s_config *config = dev->config;
@@ -217,20 +242,16 @@ static void cst816s_chip_reset(const struct device *dev)
 			return;
 		}
 
-		gpio_pin_set_dt(&config->rst_gpio, 1);
-		k_msleep(CST816S_RESET_DELAY);
-		gpio_pin_set_dt(&config->rst_gpio, 0);
+		cst816s_reset_pulse(dev);
 		k_msleep(CST816S_WAIT_DELAY);
 	}
 }
 
-static int cst816s_chip_init(const struct device *dev)
+static int cst816s_chip_configure(const struct device *dev)
 {
 	const struct cst816s_config *cfg = dev->config;
 	uint8_t chip_id;
 
-	cst816s_chip_reset(dev);
-
 	if (!device_is_ready(cfg->i2c.bus)) {
 		LOG_ERR("I2C bus %s not ready", cfg->i2c.bus->name);
 		return -ENODEV;
@@ -260,12 +281,61 @@ static int cst816s_chip_init(const struct device *dev)
 	return 0;
 }
 
+static int cst816s_chip_init(const struct device *dev)
+{
+	cst816s_chip_reset(dev);
+
+	return cst816s_chip_configure(dev);
+}
+
+static void cst816s_events_enable(const struct device *dev, bool enable)
+{
+	struct cst816s_data *data = dev->data;
+
+#ifdef CONFIG_INPUT_CST816S_INTERRUPT
+	const struct cst816s_config *config = dev->config;
+
+	ARG_UNUSED(data);
+	gpio_pin_interrupt_configure_dt(&config->int_gpio, enable ? GPIO_INT_EDGE_TO_ACTIVE : GPIO_INT_DISABLE);
+#else
+	if (enable) {
+		k_timer_start(&data->timer, K_MSEC(CONFIG_INPUT_CST816S_PERIOD), K_MSEC(CONFIG_INPUT_CST816S_PERIOD));
+	} else {
+		k_timer_stop(&data->timer);
+	}
+#endif
+}
+
+static void cst816s_resume_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct cst816s_data *data = CONTAINER_OF(dwork, struct cst816s_data, resume_work);
+
+	if (cst816s_chip_configure(data->dev) < 0) {
+		if (data->resume_retries < CST816S_RESUME_RETRIES) {
+			data->resume_retries++;
+			LOG_WRN("Could not configure chip after resume, retry %u", data->resume_retries);
+			cst816s_reset_pulse(data->dev);
+			k_work_schedule(&data->resume_work, K_MSEC(CST816S_WAIT_DELAY << data->resume_retries));
+			return;
+		}
+		// Touch is dead until reboot otherwise, the chip may still come
+		// back with its default configuration.
+		LOG_ERR("Could not configure chip after resume, enabling events anyway");
+	}
+
+	data->resume_retries = 0;
+	data->suspended = false;
+	cst816s_events_enable(data->dev, true);
+}
+
 static int cst816s_init(const struct device *dev)
 {
 	struct cst816s_data *data = dev->data;
 
 	data->dev = dev;
 	k_work_init(&data->work, cst816s_work_handler);
+	k_work_init_delayable(&data->resume_work, cst816s_resume_work_handler);
 
 	LOG_DBG("Initialize CST816S");
 
@@ -305,22 +375,38 @@ static int cst816s_init(const struct device *dev)
 static int cst816s_pm_action(const struct device *dev, enum pm_device_action action)
 {
 	const struct cst816s_config *config = dev->config;
-	int status;
+	struct cst816s_data *data = dev->data;
+	int status = 0;
 
 	LOG_DBG("Status: %u", action);
 
 	switch (action) {
 		case PM_DEVICE_ACTION_SUSPEND: {
 			LOG_DBG("State changed to suspended");
-			if (device_is_ready(config->rst_gpio.port)) {
+			// Stop touch events before the chip goes to sleep so that nothing
+			// touching the screen while it is off causes any I2C traffic.
+			data->suspended = true;
+			cst816s_events_enable(dev, false);
+			k_work_cancel_delayable_sync(&data->resume_work, &data->work_sync);
+			k_work_cancel_sync(&data->work, &data->work_sync);
+
+			// Deep sleep, the chip stops scanning and is only woken up by a reset.
+			status = i2c_reg_write_byte_dt(&config->i2c, CST816S_REG_POWER_MODE, CST816S_POWER_MODE_SLEEP);
+			if (status < 0 && device_is_ready(config->rst_gpio.port)) {
+				// Fall back to keeping the chip in reset.
 				status = gpio_pin_set_dt(&config->rst_gpio, 1);
 			}
 
 			break;
 		}
 		case PM_DEVICE_ACTION_RESUME: {
-			LOG_DBG("State changed to active");
-			status = cst816s_chip_init(dev);
+			LOG_DBG("State changed to active, %u events while suspended", data->suspended_events);
+			// Only the reset pulse is done here, the chip needs CST816S_WAIT_DELAY ms
+			// before it accepts configuration, which is done from resume_work so that
+			// waking up the display is not blocked.
+			cst816s_reset_pulse(dev);
+			data->resume_retries = 0;
+			k_work_schedule(&data->resume_work, K_MSEC(CST816S_WAIT_DELAY));
 
 			break;
 		}
@@ -26,39 +26,55 @@ LOG_MODULE_REGISTER(bosch_bsec, CONFIG_BME68X_IAQ_LOG_LEVEL);
 #define SETTINGS_KEY_STATE 				"state"
 #define SETTINGS_BSEC_STATE 			SETTINGS_NAME_BSEC "/" SETTINGS_KEY_STATE
 #define BSEC_TOTAL_HEAT_DUR				UINT16_C(140)
+#define BSEC_SAVE_STATE_TIMEOUT_MS		5000
 #define BSEC_INPUT_PRESENT(x, shift)	(x.process_data & (1 << (shift - 1)))
 
 /* Temperature offset due to external heat sources. */
 static const float temp_offset = (CONFIG_BME68X_IAQ_TEMPERATURE_OFFSET / 100.0f);
 
+#if defined(CONFIG_BME68X_IAQ_SAMPLE_RATE_ULTRA_LOW_POWER)
+#define BSEC_DEFAULT_SAMPLE_RATE		BME68X_IAQ_SAMPLE_RATE_ULP
+#elif defined(CONFIG_BME68X_IAQ_SAMPLE_RATE_CONTINUOUS)
+#define BSEC_DEFAULT_SAMPLE_RATE		BME68X_IAQ_SAMPLE_RATE_CONTINUOUS
+#else
+#define BSEC_DEFAULT_SAMPLE_RATE		BME68X_IAQ_SAMPLE_RATE_LP
+#endif
+
+/* BSEC sample rate and sample period for each bme68x_iaq_sample_rate. */
+static const float bsec_sample_rates[BME68X_IAQ_SAMPLE_RATE_NUM] = {
+	BSEC_SAMPLE_RATE_ULP,
+	BSEC_SAMPLE_RATE_LP,
+	BSEC_SAMPLE_RATE_CONT,
+};
+
+static const uint16_t bsec_sample_periods_s[BME68X_IAQ_SAMPLE_RATE_NUM] = {
+	300,
+	3,
+	1,
+};
+
 /* Define which sensor values to request.
  * The order is not important, but output_ready needs to be updated if different types
- * of sensor values are requested.
+ * of sensor values are requested. The sample rate is filled in by bsec_set_sample_rate.
  */
-static const bsec_sensor_configuration_t bsec_requested_virtual_sensors[] = {
+static bsec_sensor_configuration_t bsec_requested_virtual_sensors[] = {
 	{
 		.sensor_id   = BSEC_OUTPUT_BREATH_VOC_EQUIVALENT,
-		.sample_rate = BSEC_SAMPLE_RATE,
 	},
 	{
 		.sensor_id   = BSEC_OUTPUT_CO2_EQUIVALENT,
-		.sample_rate = BSEC_SAMPLE_RATE,
 	},
 	{
 		.sensor_id   = BSEC_OUTPUT_IAQ,
-		.sample_rate = BSEC_SAMPLE_RATE,
 	},
 	{
 		.sensor_id   = BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE,
-		.sample_rate = BSEC_SAMPLE_RATE,
 	},
 	{
 		.sensor_id   = BSEC_OUTPUT_RAW_PRESSURE,
-		.sample_rate = BSEC_SAMPLE_RATE,
 	},
 	{
 		.sensor_id   = BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY,
-		.sample_rate = BSEC_SAMPLE_RATE,
 	},
 };
 
@@ -93,6 +109,18 @@ struct bme68x_iaq_data {
 	bsec_sensor_configuration_t required_sensor_settings[BSEC_MAX_PHYSICAL_SENSOR];
 	uint8_t n_required_sensor_settings;
 
+	/* Sample rate requested through the sensor API and the one BSEC is currently subscribed with. */
+	atomic_t requested_sample_rate;
+	enum bme68x_iaq_sample_rate sample_rate;
+
+	/* Set through SENSOR_ATTR_BSEC_SAVE_STATE, cleared when the state is saved. */
+	atomic_t save_requested;
+	int save_result;
+
+	/* Statistics since boot. */
+	uint64_t heater_on_ms;
+	uint32_t wakeups;
+
 	/* some RAM space needed by bsec_get_state and bsec_set_state for (de-)serialization. */
 	uint8_t work_buffer[BSEC_MAX_WORKBUFFER_SIZE];
 
@@ -100,6 +128,9 @@ struct bme68x_iaq_data {
 };
 
 static K_SEM_DEFINE(bsec_output_sem, 1, 1);
+/* Given to wake the BSEC thread early, a give before it sleeps is not lost. */
+static K_SEM_DEFINE(bsec_wake_sem, 0, 1);
+static K_SEM_DEFINE(bsec_save_done_sem, 0, 1);
 static K_THREAD_STACK_DEFINE(bsec_thread_stack, CONFIG_BME68X_IAQ_THREAD_STACK_SIZE);
 static K_TIMER_DEFINE(bsec_save_state_timer, NULL, NULL);
 static struct i2c_dt_spec bme688;
@@ -135,8 +166,9 @@ static int bsec_load_state(const char *p_key, size_t len,
 
 /** @brief			BSEC state saving function.
  *  @param p_dev	Pointer to device structure
+ *  @return			0 when successful
 */
-static void bsec_save_state(const struct device *p_dev)
+static int bsec_save_state(const struct device *p_dev)
 {
 	int ret;
 	struct bme68x_iaq_data *data = p_dev->data;
@@ -153,6 +185,8 @@ static void bsec_save_state(const struct device *p_dev)
 	ret = settings_save_one(SETTINGS_BSEC_STATE, data->state_buffer, data->state_len);
 
 	__ASSERT(ret == 0, "storing state to flash failed!");
+
+	return ret;
 }
 
 /** @brief				BME68X I2C read function.
@@ -435,6 +469,38 @@ static void fetch_and_process_output(const struct device *p_dev,
 	}
 }
 
+/** @brief			Subscribe to all virtual sensors with the given sample rate.
+ *					Called from init and then only from the BSEC thread, as BSEC is not
+ *					thread safe. BSEC keeps its state, including the IAQ calibration, when
+ *					the subscription changes.
+ *  @param p_dev	Pointer to device structure
+ *  @param rate		New sample rate
+ *  @return			0 when successful
+*/
+static int bsec_set_sample_rate(const struct device *p_dev, enum bme68x_iaq_sample_rate rate)
+{
+	bsec_library_return_t ret;
+	struct bme68x_iaq_data *data = p_dev->data;
+
+	for (size_t i = 0; i < ARRAY_SIZE(bsec_requested_virtual_sensors); i++) {
+		bsec_requested_virtual_sensors[i].sample_rate = bsec_sample_rates[rate];
+	}
+
+	data->n_required_sensor_settings = BSEC_MAX_PHYSICAL_SENSOR;
+	ret = bsec_update_subscription(bsec_requested_virtual_sensors,
+				       ARRAY_SIZE(bsec_requested_virtual_sensors),
+				       data->required_sensor_settings, &data->n_required_sensor_settings);
+	if (ret < BSEC_OK) {
+		LOG_ERR("bsec_update_subscription error: %d", ret);
+		return -EIO;
+	}
+
+	LOG_DBG("BSEC sample rate %d -> %d", data->sample_rate, rate);
+	data->sample_rate = rate;
+
+	return 0;
+}
+
 /** @brief			BSEC run worker. The worker manages all recurrings tasks for the sensor:
  * 						- Update device settings according to BSEC
  * 						- Fetch measurement values
@@ -445,20 +511,47 @@ static void fetch_and_process_output(const struct device *p_dev,
 static void bsec_run_worker(const struct device *p_dev)
 {
 	bsec_bme_settings_t sensor_settings = {0};
+	struct bme68x_iaq_data *data = p_dev->data;
+	enum bme68x_iaq_sample_rate requested_rate;
 
 	while (true) {
+		data->wakeups++;
+
+		requested_rate = atomic_get(&data->requested_sample_rate);
+		if (requested_rate != data->sample_rate) {
+			if (requested_rate == BME68X_IAQ_SAMPLE_RATE_ULP) {
+				/* Likely to stay here for a long time, make sure the calibration is persisted. */
+				bsec_save_state(p_dev);
+			}
+			if (bsec_set_sample_rate(p_dev, requested_rate) == 0) {
+				/* Let BSEC schedule the next measurement for the new rate right away. */
+				sensor_settings.next_call = 0;
+			}
+		}
+
+		/* Serviced before waiting for the next measurement, the caller is blocked on it. */
+		if (atomic_cas(&data->save_requested, 1, 0)) {
+			data->save_result = bsec_save_state(p_dev);
+			k_sem_give(&bsec_save_done_sem);
+		}
+
 		uint64_t timestamp_ns = k_ticks_to_ns_floor64(k_uptime_ticks());
 
 		if (timestamp_ns < sensor_settings.next_call) {
 			LOG_DBG("bsec_sensor_control not ready yet");
-			k_sleep(K_NSEC(sensor_settings.next_call - timestamp_ns));
+			k_sem_take(&bsec_wake_sem, K_NSEC(sensor_settings.next_call - timestamp_ns));
 			continue;
 		}
 
 		memset(&sensor_settings, 0, sizeof(sensor_settings));
-		if (bsec_sensor_control((int64_t)timestamp_ns, &sensor_settings) != BSEC_OK) {
-			LOG_ERR("bsec_sensor_control error!");
+		bsec_library_return_t ret = bsec_sensor_control((int64_t)timestamp_ns, &sensor_settings);
+		if (ret < BSEC_OK) {
+			LOG_ERR("bsec_sensor_control error: %d", ret);
+			k_sem_take(&bsec_wake_sem, K_SECONDS(bsec_sample_periods_s[data->sample_rate]));
 			continue;
+		} else if (ret > BSEC_OK) {
+			/* Warnings, e.g. call timing violation right after a sample rate change. */
+			LOG_DBG("bsec_sensor_control warning: %d", ret);
 		}
 
 		if (apply_sensor_settings(p_dev, sensor_settings)) {
@@ -467,17 +560,24 @@ static void bsec_run_worker(const struct device *p_dev)
 
 		if (sensor_settings.trigger_measurement &&
 		    sensor_settings.op_mode != BME68X_SLEEP_MODE) {
+			if (sensor_settings.op_mode == BME68X_PARALLEL_MODE) {
+				data->heater_on_ms += BSEC_TOTAL_HEAT_DUR;
+			} else {
+				data->heater_on_ms += sensor_settings.heater_duration;
+			}
 			fetch_and_process_output(p_dev, &sensor_settings, timestamp_ns);
 		}
 
-		if (k_timer_remaining_get(&bsec_save_state_timer) == 0) {
+		if (CONFIG_BME68X_IAQ_SAVE_INTERVAL_MINUTES > 0 &&
+			   k_timer_remaining_get(&bsec_save_state_timer) == 0) {
 			bsec_save_state(p_dev);
 			k_timer_start(&bsec_save_state_timer,
 				      K_MINUTES(CONFIG_BME68X_IAQ_SAVE_INTERVAL_MINUTES),
 				      K_NO_WAIT);
 		}
 
-		k_sleep(K_SECONDS(BSEC_SAMPLE_PERIOD_S));
+		/* Woken up early by bme68x_attr_set for a sample rate change or a state save. */
+		k_sem_take(&bsec_wake_sem, K_SECONDS(bsec_sample_periods_s[data->sample_rate]));
 	}
 }
 
@@ -560,9 +660,10 @@ static int bme68x_bsec_init(const struct device *p_dev)
 		LOG_DBG("Setting BSEC state successful.");
 	}
 
-	bsec_update_subscription(bsec_requested_virtual_sensors,
-				 ARRAY_SIZE(bsec_requested_virtual_sensors),
-				 data->required_sensor_settings, &data->n_required_sensor_settings);
+	atomic_set(&data->requested_sample_rate, BSEC_DEFAULT_SAMPLE_RATE);
+	if (bsec_set_sample_rate(p_dev, BSEC_DEFAULT_SAMPLE_RATE)) {
+		return -EFAULT;
+	}
 
 	k_thread_create(&data->thread,
 			bsec_thread_stack,
@@ -570,9 +671,11 @@ static int bme68x_bsec_init(const struct device *p_dev)
 			(k_thread_entry_t)bsec_run_worker,
 			(void*)p_dev, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
 
-	k_timer_start(&bsec_save_state_timer,
-		      K_MINUTES(CONFIG_BME68X_IAQ_SAVE_INTERVAL_MINUTES),
-		      K_NO_WAIT);
+	if (CONFIG_BME68X_IAQ_SAVE_INTERVAL_MINUTES > 0) {
+		k_timer_start(&bsec_save_state_timer,
+			      K_MINUTES(CONFIG_BME68X_IAQ_SAVE_INTERVAL_MINUTES),
+			      K_NO_WAIT);
+	}
 
 	LOG_DBG("BSEC driver started");
 
@@ -614,6 +717,83 @@ static int bme68x_trigger_set(const struct device *p_dev,
 	return 0;
 }
 
+/** @brief			Sensor API attribute set function.
+ *					Switches the BSEC sample rate or saves the BSEC state, both are
+ *					applied by the BSEC thread. A state save blocks until the state
+ *					is written to flash.
+ *  @param p_dev	Pointer to device structure
+ *  @param chan		Sensor channel
+ *  @param attr		Sensor attribute
+ *  @param p_val	Pointer to attribute value
+ *  @return			0 when successful
+*/
+static int bme68x_attr_set(const struct device *p_dev,
+			   enum sensor_channel chan,
+			   enum sensor_attribute attr,
+			   const struct sensor_value *p_val)
+{
+	struct bme68x_iaq_data *data = p_dev->data;
+
+	if ((int)attr == SENSOR_ATTR_BSEC_SAVE_STATE) {
+		if (k_current_get() == &data->thread) {
+			return -EDEADLK;
+		}
+		k_sem_reset(&bsec_save_done_sem);
+		atomic_set(&data->save_requested, 1);
+		k_sem_give(&bsec_wake_sem);
+		if (k_sem_take(&bsec_save_done_sem, K_MSEC(BSEC_SAVE_STATE_TIMEOUT_MS)) != 0) {
+			return -EAGAIN;
+		}
+		return data->save_result;
+	}
+
+	if ((int)attr != SENSOR_ATTR_BSEC_SAMPLE_RATE) {
+		return -ENOTSUP;
+	}
+
+	if ((p_val->val1 < 0) || (p_val->val1 >= BME68X_IAQ_SAMPLE_RATE_NUM)) {
+		return -EINVAL;
+	}
+
+	if (atomic_set(&data->requested_sample_rate, p_val->val1) != p_val->val1) {
+		k_sem_give(&bsec_wake_sem);
+	}
+
+	return 0;
+}
+
+/** @brief			Sensor API attribute get function.
+ *  @param p_dev	Pointer to device structure
+ *  @param chan		Sensor channel
+ *  @param attr		Sensor attribute
+ *  @param p_val	Pointer to attribute value
+ *  @return			0 when successful
+*/
+static int bme68x_attr_get(const struct device *p_dev,
+			   enum sensor_channel chan,
+			   enum sensor_attribute attr,
+			   struct sensor_value *p_val)
+{
+	struct bme68x_iaq_data *data = p_dev->data;
+
+	switch ((int)attr) {
+	case SENSOR_ATTR_BSEC_SAMPLE_RATE:
+		p_val->val1 = atomic_get(&data->requested_sample_rate);
+		break;
+	case SENSOR_ATTR_BSEC_HEATER_ON_MS:
+		p_val->val1 = (int32_t)MIN(data->heater_on_ms, INT32_MAX);
+		break;
+	case SENSOR_ATTR_BSEC_WAKEUPS:
+		p_val->val1 = data->wakeups;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+	p_val->val2 = 0;
+
+	return 0;
+}
+
 /** @brief			Sensor API sample fetch function.
  *					NOTE: We don´t use this function, because the background thread is refreshing the
  *					values permanently. The function must stay in the code, because the device subsystem
@@ -668,6 +848,8 @@ static const struct sensor_driver_api bme68x_driver_api = {
 	.sample_fetch = &bme68x_sample_fetch,
 	.channel_get = &bme68x_channel_get,
 	.trigger_set = bme68x_trigger_set,
+	.attr_set = bme68x_attr_set,
+	.attr_get = bme68x_attr_get,
 };
 
 static struct bme68x_iaq_config config_0 =  {
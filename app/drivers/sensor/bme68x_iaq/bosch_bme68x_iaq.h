@@ -13,4 +13,21 @@
 
 /** @brief IAQ sensor channel.
 */
-#define SENSOR_CHAN_IAQ                 (SENSOR_CHAN_PRIV_START + 1)
\ No newline at end of file
+#define SENSOR_CHAN_IAQ                 (SENSOR_CHAN_PRIV_START + 1)
+
+/** @brief Private attributes of the BSEC driver.
+*/
+#define SENSOR_ATTR_BSEC_SAMPLE_RATE    (SENSOR_ATTR_PRIV_START + 1)    /* Set/get, val1 is a bme68x_iaq_sample_rate */
+#define SENSOR_ATTR_BSEC_HEATER_ON_MS   (SENSOR_ATTR_PRIV_START + 2)    /* Get, heater on time since boot in ms */
+#define SENSOR_ATTR_BSEC_WAKEUPS        (SENSOR_ATTR_PRIV_START + 3)    /* Get, BSEC thread wakeups since boot */
+#define SENSOR_ATTR_BSEC_SAVE_STATE     (SENSOR_ATTR_PRIV_START + 4)    /* Set, save BSEC state to flash and wait for it, value ignored */
+
+/** @brief BSEC sample rates that can be switched between at runtime.
+ *         The BSEC state, and with that the IAQ calibration, is kept when switching.
+*/
+enum bme68x_iaq_sample_rate {
+	BME68X_IAQ_SAMPLE_RATE_ULP,			/* Every 300 seconds */
+	BME68X_IAQ_SAMPLE_RATE_LP,			/* Every 3 seconds */
+	BME68X_IAQ_SAMPLE_RATE_CONTINUOUS,	/* Every second */
+	BME68X_IAQ_SAMPLE_RATE_NUM,
+};
@@ -1,5 +1,6 @@
 import os
 import argparse
+import hashlib
 from struct import *
 
 MAX_FILE_NAME = 16
@@ -16,26 +17,53 @@ filename[MAX_FILE_NAME + 1]
 offset:uint32
 len:uint32
 ...
+
+Files are stored content addressed, identical files (also across source
+directories) are stored once and all their names point to the same blob.
+The table is sorted by name so the target can binary search it.
 """
 
 
+def blob_hash(data):
+    return hashlib.sha256(data).hexdigest()
+
+
+def blob_hashes(source_dir):
+    hashes = set()
+    for root, dirs, files in os.walk(source_dir):
+        for filename in files:
+            with open(os.path.join(root, filename), "rb") as infile:
+                hashes.add(blob_hash(infile.read()))
+    return hashes
+
+
 def create_custom_raw_fs_image(img_filename, source_dir, block_size=4096):
     table = {}
+    blobs = {}
     offset = 0
+    reclaimed = 0
     files_image = bytearray()
     header_images = bytearray()
     for root, dirs, files in os.walk(source_dir):
         print(f"root {root} dirs {dirs} files {files}")
         for filename in files:
             path = os.path.join(root, filename)
-            relpath = os.path.relpath(path, start=source_dir)
-            print(f"Adding {path}")
             with open(path, "rb") as infile:
-                files_image.extend(infile.read())
-                table[filename] = {"offset": offset, "len": infile.tell()}
-                offset = offset + infile.tell()
+                data = infile.read()
+            digest = blob_hash(data)
+            if digest in blobs:
+                print(f"Adding {path} (same content as stored blob, not stored again)")
+                reclaimed = reclaimed + len(data)
+            else:
+                print(f"Adding {path}")
+                blobs[digest] = {"offset": offset, "len": len(data)}
+                files_image.extend(data)
+                offset = offset + len(data)
+            table[filename] = blobs[digest]
     print(table)
-    for name, data in table.items():
+    print(f"{len(table)} files in {len(blobs)} blobs, {reclaimed} bytes deduplicated")
+    # Target does strncmp on the raw names, sort on the same bytes.
+    for name, data in sorted(table.items(), key=lambda item: bytes(item[0], "utf-8")):
         if len(name) <= MAX_FILE_NAME:
             header_images = header_images + pack(
                 f"<{MAX_FILE_NAME}sII",
@@ -1,6 +1,7 @@
 import os
 import argparse
 from littlefs import LittleFS
+from create_custom_resource_image import blob_hash, blob_hashes
 
 
 def create_littlefs_fs_image(
@@ -14,6 +15,7 @@ def create_littlefs_fs_image(
     attr_max,
     source_dir,
     disk_version,
+    exclude_dir=None,
 ):
     block_count = img_size // block_size
     if block_count * block_size != img_size:
@@ -42,6 +44,12 @@ def create_littlefs_fs_image(
         disk_version=disk_version,
     )
 
+    # Files with the same content as a file in exclude_dir are already stored
+    # in the raw resource image. Skipping them would make "/lvgl_lfs/<name>"
+    # fail to open at runtime, so refuse to build and let the asset be moved.
+    excluded_hashes = blob_hashes(exclude_dir) if exclude_dir else set()
+    duplicates = []
+
     # Note: path component separator etc are assumed to be compatible
     # between littlefs and host.
     for root, dirs, files in os.walk(source_dir):
@@ -54,10 +62,20 @@ def create_littlefs_fs_image(
         for f in files:
             path = os.path.join(root, f)
             relpath = os.path.relpath(path, start=source_dir)
-            print(f"Copying {path} to {relpath}")
             with open(path, "rb") as infile:
-                with fs.open(relpath, "wb") as outfile:
-                    outfile.write(infile.read())
+                data = infile.read()
+            if blob_hash(data) in excluded_hashes:
+                duplicates.append(path)
+                continue
+            print(f"Copying {path} to {relpath}")
+            with fs.open(relpath, "wb") as outfile:
+                outfile.write(data)
+
+    if duplicates:
+        for path in duplicates:
+            print(f"{path} has the same content as a file in {exclude_dir}")
+        print("Remove them and open the copy in the raw image with \"S:<name>\" instead")
+        exit(1)
 
     with open(img_filename, "wb") as f:
         f.write(fs.context.buffer)
@@ -75,6 +93,11 @@ if __name__ == "__main__":
     parser.add_argument("--file-max", type=int, default=0)
     parser.add_argument("--attr-max", type=int, default=0)
     parser.add_argument("--disk-version", default=None)
+    parser.add_argument(
+        "--exclude-dir",
+        default=None,
+        help="Fail if a file has the same content as a file in this directory",
+    )
     parser.add_argument("source")
     args = parser.parse_args()
 
@@ -99,4 +122,5 @@ if __name__ == "__main__":
         attr_max,
         source_dir,
         args.disk_version,
+        args.exclude_dir,
     )
@@ -0,0 +1,129 @@
+import json
+import argparse
+from struct import *
+
+"""
+Converts a JSON watchface description into the binary layout read by
+src/ui/watchfaces/zsw_watchface_layout_ui.c. Put the output into the littlefs
+resource folder under watchfaces/ and any images into the raw resource folder.
+
+{
+    "bg_color": "0x000000",
+    "bg_img": "space.bin",
+    "elements": [
+        {"type": "img", "binding": "hour_hand", "src": "hour.bin", "align": "center",
+         "x": 0, "y": -32, "pivot_x": 18, "pivot_y": 82, "color": "0x0EA7FF"},
+        {"type": "label", "binding": "date", "align": "right_mid", "x": -10, "font": 16},
+        {"type": "arc", "binding": "battery", "x": -60, "w": 40, "h": 40, "max": 100}
+    ]
+}
+"""
+
+MAGIC = 0x3146575A
+VERSION = 1
+NAME_LEN = 16
+MAX_ELEMENTS = 32
+
+TYPES = ["img", "label", "arc"]
+BINDINGS = [
+    "none",
+    "hour_hand",
+    "minute_hand",
+    "second_hand",
+    "time",
+    "seconds",
+    "date",
+    "battery",
+    "steps",
+    "hrm",
+    "notifications",
+    "ble_connected",
+    "weather_temperature",
+    "weather_icon",
+    "temperature",
+    "humidity",
+    "pressure",
+]
+# Same order as lv_align_t
+ALIGNS = [
+    "default",
+    "top_left",
+    "top_mid",
+    "top_right",
+    "bottom_left",
+    "bottom_mid",
+    "bottom_right",
+    "left_mid",
+    "right_mid",
+    "center",
+]
+FONTS = [10, 12, 14, 16, 18, 20]
+# Images keep their own colors unless a recolor is given, 0 means no recolor.
+DEFAULT_COLORS = {"img": 0, "label": 0xFFFFFF, "arc": 0xFFFFFF}
+
+
+def parse_color(value):
+    if isinstance(value, str):
+        return int(value, 16)
+    return value
+
+
+def pack_name(name):
+    encoded = bytes(name, "utf-8")
+    if len(encoded) >= NAME_LEN:
+        raise ValueError(f"'{name}' too long, max {NAME_LEN - 1} characters")
+    return encoded
+
+
+def pack_element(element):
+    return pack(
+        f"<BBBBhhhhIhhi{NAME_LEN}s",
+        TYPES.index(element["type"]),
+        BINDINGS.index(element.get("binding", "none")),
+        ALIGNS.index(element.get("align", "center")),
+        FONTS.index(element.get("font", 14)),
+        element.get("x", 0),
+        element.get("y", 0),
+        element.get("w", 0),
+        element.get("h", 0),
+        parse_color(element.get("color", DEFAULT_COLORS[element["type"]])),
+        element.get("pivot_x", 0),
+        element.get("pivot_y", 0),
+        element.get("max", 100),
+        pack_name(element.get("src", "")),
+    )
+
+
+def create_watchface_layout(layout_filename, output_filename):
+    with open(layout_filename, "r") as infile:
+        layout = json.load(infile)
+
+    elements = layout["elements"]
+    if len(elements) == 0 or len(elements) > MAX_ELEMENTS:
+        raise ValueError(f"Layout must have 1 to {MAX_ELEMENTS} elements")
+
+    image = pack(
+        f"<IHHI{NAME_LEN}s",
+        MAGIC,
+        VERSION,
+        len(elements),
+        parse_color(layout.get("bg_color", 0)),
+        pack_name(layout.get("bg_img", "")),
+    )
+    for element in elements:
+        image = image + pack_element(element)
+
+    with open(output_filename, "wb") as outfile:
+        outfile.write(image)
+    print(f"Wrote {len(elements)} elements ({len(image)} bytes) to {output_filename}")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Create a binary watchface layout file from a JSON description."
+    )
+    parser.add_argument("-l", "--layout", type=str, required=True, help="JSON layout file")
+    parser.add_argument("-o", "--output", type=str, required=True, help="Output .zwf file")
+    args = parser.parse_args()
+
+    create_watchface_layout(args.layout, args.output)
@@ -75,6 +75,7 @@ class UploadFsWestCommand(WestCommand):
                     attr_max,
                     source_dir,
                     disk_version,
+                    f"{images_path}/S",
                 )
         log.inf("Uploading image")
         sys.exit(
@@ -4,6 +4,7 @@
 
 #include "accel_ui.h"
 #include "sensors/zsw_imu.h"
+#include "sensors/zsw_sensor_history.h"
 #include "events/zsw_periodic_event.h"
 #include "managers/zsw_app_manager.h"
 
@@ -26,7 +27,13 @@ static application_t app = {
 
 static void accel_app_start(lv_obj_t *root, lv_group_t *group)
 {
+    zsw_sensor_history_sample_t sample;
+
     accel_ui_show(root, on_close_accel);
+    // Show the last known values until the first new sample arrives.
+    if (zsw_sensor_history_get_latest(ZSW_SENSOR_HISTORY_ACCEL, &sample) == 0) {
+        accel_ui_set_values((int32_t)sample.values[0], (int32_t)sample.values[1], (int32_t)sample.values[2]);
+    }
     zsw_periodic_chan_add_obs(&periodic_event_fast_chan, &accel_app_lis);
 }
 
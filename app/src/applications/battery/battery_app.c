@@ -14,7 +14,9 @@ static void battery_app_start(lv_obj_t *root, lv_group_t *group);
 static void battery_app_stop(void);
 
 static void zbus_battery_sample_data_callback(const struct zbus_channel *chan);
-static int get_num_samples(void);
+static int read_samples(uint32_t from_s, zsw_ui_lod_chart_sample_t *samples, int max_samples, void *user_data);
+static uint32_t get_now_s(void);
+static void handle_new_sample(struct k_work *item);
 
 typedef struct battery_sample_t {
     int mV;
@@ -33,8 +35,11 @@ static application_t app = {
     .stop_func = battery_app_stop
 };
 
+static K_WORK_DEFINE(new_sample_work, handle_new_sample);
+
 static battery_sample_t battery_samples[CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX];
 static int next_battery_sample_index;
+static bool running;
 
 static void battery_app_start(lv_obj_t *root, lv_group_t *group)
 {
@@ -53,22 +58,55 @@ static void battery_app_start(lv_obj_t *root, lv_group_t *group)
         LOG_ERR("Failed disable battery measurement: %d\n", rc);
     }
 
-    battery_ui_show(root, get_num_samples() + 1);
+    battery_ui_show(root, read_samples, get_now_s);
     battery_ui_set_current_measurement(batt_mv);
-    for (int i = 0; i < CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX; i++) {
-        if (battery_samples[(next_battery_sample_index + i) % CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX].timestamp !=
-            0) {
-            battery_ui_add_measurement(battery_samples[(next_battery_sample_index + i) %
-                                                                                       CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX].mV);
-        }
-    }
+    running = true;
 }
 
 static void battery_app_stop(void)
 {
+    zsw_ui_lod_chart_stats_t stats;
+
+    battery_ui_get_chart_stats(&stats);
+    LOG_DBG("Chart: %d bytes, draw %d us, page in %d samples %d us", stats.ram_bytes, stats.last_draw_us,
+            stats.last_page_in_samples, stats.last_page_in_us);
+    running = false;
     battery_ui_remove();
 }
 
+static int read_samples(uint32_t from_s, zsw_ui_lod_chart_sample_t *samples, int max_samples, void *user_data)
+{
+    battery_sample_t *sample;
+    int num_samples = 0;
+
+    // Oldest first, the chart pages through the history with increasing from_s.
+    for (int i = 0; i < CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX && num_samples < max_samples; i++) {
+        sample = &battery_samples[(next_battery_sample_index + i) % CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX];
+        if (sample->timestamp != 0 && sample->timestamp / 1000 >= from_s) {
+            samples[num_samples].timestamp_s = sample->timestamp / 1000;
+            samples[num_samples].value = sample->mV;
+            num_samples++;
+        }
+    }
+
+    return num_samples;
+}
+
+static uint32_t get_now_s(void)
+{
+    return k_uptime_get() / 1000;
+}
+
+static void handle_new_sample(struct k_work *item)
+{
+    int last_index = (next_battery_sample_index + CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX - 1) %
+                     CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX;
+
+    if (running) {
+        battery_ui_add_measurement(battery_samples[last_index].timestamp / 1000, battery_samples[last_index].mV);
+    }
+}
+
 static void zbus_battery_sample_data_callback(const struct zbus_channel *chan)
 {
     const struct battery_sample_event *event = zbus_chan_const_msg(chan);
@@ -86,25 +124,13 @@ static void zbus_battery_sample_data_callback(const struct zbus_channel *chan)
         battery_samples[next_battery_sample_index].timestamp = k_uptime_get();
         LOG_DBG("Add %d\n", battery_samples[next_battery_sample_index].mV);
         next_battery_sample_index = (next_battery_sample_index + 1) % CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX;
+        k_work_submit(&new_sample_work);
     } else {
         LOG_DBG("Discard sample: %d, %d\n", battery_samples[previous_sample_index].mV,
                 (int)(k_uptime_get() - battery_samples[previous_sample_index].timestamp));
     }
 }
 
-static int get_num_samples(void)
-{
-    int num_samples = 0;
-
-    for (int i = 0; i < CONFIG_DEFAULT_CONFIGURATION_BATTERY_NUM_SAMPLES_MAX; i++) {
-        if (battery_samples[i].timestamp != 0) {
-            num_samples++;
-        }
-    }
-
-    return num_samples;
-}
-
 static int battery_app_add(void)
 {
     zsw_app_manager_add_application(&app);
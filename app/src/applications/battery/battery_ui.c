@@ -1,16 +1,37 @@
+#include <string.h>
 #include <battery/battery_ui.h>
 #include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#include "ui/utils/zsw_ui_lod_chart.h"
+
+#define SECONDS_PER_DAY (24 * 60 * 60)
+
+static void chart_clicked_cb(lv_event_t *e);
 
 static lv_obj_t *root_page = NULL;
 
 static lv_obj_t *chart;
-static lv_chart_series_t *ser;
+static lv_obj_t *title_label;
 static lv_obj_t *last_sample_label;
+static uint32_t (*get_now_s)(void);
+
+static const struct {
+    uint32_t span_s;
+    const char *title;
+} spans[] = {
+    { SECONDS_PER_DAY, "Battery 1 day (mV)" },
+    { 7 * SECONDS_PER_DAY, "Battery 7 days (mV)" },
+    { 30 * SECONDS_PER_DAY, "Battery 30 days (mV)" },
+};
+static int span_index;
 
-void battery_ui_show(lv_obj_t *root, int max_samples)
+void battery_ui_show(lv_obj_t *root, zsw_ui_lod_chart_read_cb_t read_cb, uint32_t (*now_s)(void))
 {
     assert(root_page == NULL);
 
+    get_now_s = now_s;
+
     // Create the root container
     root_page = lv_obj_create(root);
     // Remove the default border
@@ -22,34 +43,34 @@ void battery_ui_show(lv_obj_t *root, int max_samples)
     // Does not loog very good on the round display.
     lv_obj_set_scrollbar_mode(root_page, LV_SCROLLBAR_MODE_OFF);
 
-    chart = lv_chart_create(root_page);
-    lv_obj_set_size(chart, 150, 150);
-    lv_obj_align(chart, LV_ALIGN_CENTER, 20, 0);
-
-    lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
-    lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_SHIFT);
-    lv_chart_set_axis_tick(chart, LV_CHART_AXIS_PRIMARY_Y, 4, 5, 6, 5, true, 40);
-    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 3600, 4250);
-
-    if (max_samples > 10) {
-        lv_obj_set_style_size(chart, 0, LV_PART_INDICATOR);
+    // One min/max bucket per pixel column, same cost for a day as for a month.
+    chart = zsw_ui_lod_chart_create(root_page, 150, 150, 3600, 4250, lv_palette_main(LV_PALETTE_RED), read_cb, NULL);
+    if (!chart) {
+        return;
     }
+    lv_obj_align(chart, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_set_style_border_width(chart, 1, LV_PART_MAIN);
+    lv_obj_set_style_border_color(chart, lv_palette_main(LV_PALETTE_GREY), LV_PART_MAIN);
+    lv_obj_add_flag(chart, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(chart, chart_clicked_cb, LV_EVENT_CLICKED, NULL);
 
-    ser = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
-    lv_chart_set_point_count(chart, max_samples);
-    lv_obj_t *label = lv_label_create(root_page);
-    lv_label_set_text(label, "Battery hourly (mV)");
-    lv_obj_align_to(label, chart, LV_ALIGN_OUT_TOP_MID, -20, -5);
+    title_label = lv_label_create(root_page);
+    lv_obj_align_to(title_label, chart, LV_ALIGN_OUT_TOP_MID, 0, -5);
 
     last_sample_label = lv_label_create(root_page);
     lv_label_set_text(last_sample_label, "---- mV");
-    lv_obj_align_to(last_sample_label, chart, LV_ALIGN_OUT_BOTTOM_MID, -20, 10);
+    lv_obj_align_to(last_sample_label, chart, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
+
+    span_index = 0;
+    lv_label_set_text(title_label, spans[span_index].title);
+    zsw_ui_lod_chart_set_span(chart, spans[span_index].span_s, get_now_s());
 }
 
 void battery_ui_remove(void)
 {
     lv_obj_del(root_page);
     root_page = NULL;
+    chart = NULL;
 }
 
 void battery_ui_set_current_measurement(int value)
@@ -57,7 +78,26 @@ void battery_ui_set_current_measurement(int value)
     lv_label_set_text_fmt(last_sample_label, "%d mV", value);
 }
 
-void battery_ui_add_measurement(int value)
+void battery_ui_add_measurement(uint32_t timestamp_s, int value)
+{
+    if (chart) {
+        zsw_ui_lod_chart_add_sample(chart, timestamp_s, value);
+    }
+}
+
+void battery_ui_get_chart_stats(zsw_ui_lod_chart_stats_t *stats)
+{
+    if (chart) {
+        zsw_ui_lod_chart_get_stats(chart, stats);
+    } else {
+        memset(stats, 0, sizeof(zsw_ui_lod_chart_stats_t));
+    }
+}
+
+static void chart_clicked_cb(lv_event_t *e)
 {
-    lv_chart_set_next_value(chart, ser, value);
+    span_index = (span_index + 1) % ARRAY_SIZE(spans);
+    lv_label_set_text(title_label, spans[span_index].title);
+    lv_obj_align_to(title_label, chart, LV_ALIGN_OUT_TOP_MID, 0, -5);
+    zsw_ui_lod_chart_set_span(chart, spans[span_index].span_s, get_now_s());
 }
@@ -3,12 +3,16 @@
 #include <inttypes.h>
 #include <lvgl.h>
 
+#include "ui/utils/zsw_ui_lod_chart.h"
+
 typedef void(*on_ui_increment_cb_t)(void);
 
-void battery_ui_show(lv_obj_t *root, int max_samples);
+void battery_ui_show(lv_obj_t *root, zsw_ui_lod_chart_read_cb_t read_cb, uint32_t (*now_s)(void));
 
 void battery_ui_remove(void);
 
 void battery_ui_set_current_measurement(int value);
 
-void battery_ui_add_measurement(int value);
+void battery_ui_add_measurement(uint32_t timestamp_s, int value);
+
+void battery_ui_get_chart_stats(zsw_ui_lod_chart_stats_t *stats);
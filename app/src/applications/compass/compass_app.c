@@ -5,6 +5,7 @@
 #include "compass_ui.h"
 #include "ui/popup/zsw_popup_window.h"
 #include "sensors/zsw_magnetometer.h"
+#include "sensors/zsw_sensor_history.h"
 #include "managers/zsw_app_manager.h"
 
 LOG_MODULE_REGISTER(compass_app, LOG_LEVEL_DBG);
@@ -22,12 +23,15 @@ static application_t app = {
     .name = "Compass",
     .icon = &move,
     .start_func = compass_app_start,
-    .stop_func = compass_app_stop
+    .stop_func = compass_app_stop,
+    // The compass rotates the whole dial, render it in one pass.
+    .full_frame_render = true,
 };
 
 static lv_timer_t *refresh_timer;
 static bool is_calibrating;
 static uint32_t cal_start_ms;
+static uint32_t last_sample_ms;
 
 static void compass_app_start(lv_obj_t *root, lv_group_t *group)
 {
@@ -37,6 +41,7 @@ static void compass_app_start(lv_obj_t *root, lv_group_t *group)
     zsw_magnetometer_start_calibration();
     is_calibrating = true;
     cal_start_ms = lv_tick_get();
+    last_sample_ms = 0;
     zsw_popup_show("Calibration", "Spin around 360 degrees for 10.", NULL, 100, false);
 }
 
@@ -60,7 +65,14 @@ static void timer_callback(lv_timer_t *timer)
         zsw_popup_remove();
     }
     if (!is_calibrating) {
-        compass_ui_set_heading(zsw_magnetometer_get_heading());
+        zsw_sensor_history_sample_t sample;
+
+        // Only redraw the dial when the magnetometer produced a new sample.
+        if (zsw_sensor_history_get_latest(ZSW_SENSOR_HISTORY_MAGNETOMETER, &sample) == 0 &&
+            sample.timestamp_ms != last_sample_ms) {
+            last_sample_ms = sample.timestamp_ms;
+            compass_ui_set_heading(zsw_magnetometer_xyz_to_heading(sample.values[0], sample.values[1], sample.values[2]));
+        }
     }
 }
 
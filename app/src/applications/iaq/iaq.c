@@ -39,6 +39,7 @@ static void iaq_app_start(lv_obj_t *root, lv_group_t *group)
     LOG_DBG("Starting UI...");
 
     iaq_app_ui_show(root);
+    zsw_environment_sensor_set_iaq_viewed(true);
 
     refresh_timer = lv_timer_create(on_timer_event, 10 * 1000UL,  NULL);
 }
@@ -49,6 +50,7 @@ static void iaq_app_stop(void)
 
     lv_timer_del(refresh_timer);
     iaq_app_ui_remove();
+    zsw_environment_sensor_set_iaq_viewed(false);
 }
 
 static int iaq_app_add(void)
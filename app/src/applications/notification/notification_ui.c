@@ -1,5 +1,6 @@
 #include <notification/notification_ui.h>
 #include <lvgl.h>
+#include "ui/utils/zsw_ui_text_layout.h"
 
 static void not_button_pressed(lv_event_t *e);
 static void scroll_event_cb(lv_event_t *e);
@@ -93,6 +94,8 @@ static void build_notification_entry(lv_obj_t *parent, zsw_not_mngr_notification
     lv_obj_set_size(title, LV_PCT(100), LV_SIZE_CONTENT);
     lv_obj_add_flag(title, LV_OBJ_FLAG_CLICK_FOCUSABLE);
     lv_obj_set_style_text_font(title, &lv_font_montserrat_14_full, 0);
+    // Scrolling re-lays out the whole list, don't re-measure long bodies every time.
+    zsw_ui_text_layout_cache_attach(title);
 }
 
 static void not_button_pressed(lv_event_t *e)
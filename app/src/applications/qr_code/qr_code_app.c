@@ -1,14 +1,28 @@
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/init.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/settings/settings.h>
 #include "drivers/zsw_display_control.h"
 
 #include "qr_code_ui.h"
+#include "qr_code_image.h"
+#include "events/ble_data_event.h"
 #include "managers/zsw_app_manager.h"
+#include "zsw_settings.h"
 
 // Functions needed for all applications
 static void qr_code_app_start(lv_obj_t *root, lv_group_t *group);
 static void qr_code_app_stop(void);
 
+static void zbus_ble_comm_data_callback(const struct zbus_channel *chan);
+static void handle_new_text(struct k_work *item);
+
+ZBUS_CHAN_DECLARE(ble_comm_data_chan);
+ZBUS_LISTENER_DEFINE(qr_code_app_ble_comm_lis, zbus_ble_comm_data_callback);
+
+static K_WORK_DEFINE(new_text_work, handle_new_text);
+
 LV_IMG_DECLARE(qr_code_icon);
 
 static application_t app = {
@@ -19,24 +33,75 @@ static application_t app = {
 };
 
 static uint8_t original_brightness;
+static bool running;
+static char qr_text[MAX_QR_CODE_TEXT_LENGTH + 1] = CONFIG_APPLICATIONS_QR_CODE_DEFAULT_TEXT;
+static char new_qr_text[MAX_QR_CODE_TEXT_LENGTH + 1];
 
 static void qr_code_app_start(lv_obj_t *root, lv_group_t *group)
 {
     original_brightness = zsw_display_control_get_brightness();
     zsw_display_control_set_brightness(100);
-    qr_code_ui_show(root);
+    qr_code_ui_show(root, qr_code_image_get(qr_text));
+    running = true;
 }
 
 static void qr_code_app_stop(void)
 {
+    running = false;
     zsw_display_control_set_brightness(original_brightness);
     qr_code_ui_remove();
 }
 
+static void zbus_ble_comm_data_callback(const struct zbus_channel *chan)
+{
+    // We are here in host bluetooth thread, store and update from the workqueue.
+    const struct ble_data_event *event = zbus_chan_const_msg(chan);
+
+    if (event->data.type == BLE_COMM_DATA_TYPE_QR_CODE) {
+        memcpy(new_qr_text, event->data.data.qr_code.text, sizeof(new_qr_text));
+        k_work_submit(&new_text_work);
+    }
+}
+
+static void handle_new_text(struct k_work *item)
+{
+    if (strcmp(new_qr_text, qr_text) == 0) {
+        return;
+    }
+
+    strcpy(qr_text, new_qr_text);
+    settings_save_one(ZSW_SETTINGS_QR_CODE_TEXT, qr_text, strlen(qr_text) + 1);
+    if (running) {
+        qr_code_ui_set_image(qr_code_image_get(qr_text));
+    }
+}
+
+static int settings_load_handler(const char *key, size_t len,
+                                 settings_read_cb read_cb, void *cb_arg, void *param)
+{
+    int rc;
+
+    if (len > sizeof(qr_text)) {
+        return -EINVAL;
+    }
+
+    rc = read_cb(cb_arg, qr_text, len);
+    if (rc >= 0) {
+        qr_text[sizeof(qr_text) - 1] = '\0';
+        return 0;
+    }
+
+    return -ENODATA;
+}
+
 static int qr_code_app_add(void)
 {
     zsw_app_manager_add_application(&app);
 
+    settings_subsys_init();
+    settings_load_subtree_direct(ZSW_SETTINGS_QR_CODE_TEXT, settings_load_handler, NULL);
+    zbus_chan_add_obs(&ble_comm_data_chan, &qr_code_app_ble_comm_lis, K_MSEC(100));
+
     return 0;
 }
 
@@ -0,0 +1,89 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <src/extra/libs/qrcode/qrcodegen.h>
+
+#include "qr_code_image.h"
+#include "ble/ble_comm.h"
+
+LOG_MODULE_REGISTER(qr_code_image, LOG_LEVEL_INF);
+
+// Largest square inside the 240 px round display.
+#define MAX_IMAGE_SIZE      168
+#define QUIET_ZONE_MODULES  2
+// Version 6 (41x41 modules) fits MAX_QR_CODE_TEXT_LENGTH bytes at medium error correction.
+#define MAX_VERSION         6
+#define PALETTE_SIZE        (2 * sizeof(lv_color32_t))
+#define STRIDE(w)           (((w) + 7) / 8)
+
+static uint8_t qr_buf[qrcodegen_BUFFER_LEN_FOR_VERSION(MAX_VERSION)];
+static uint8_t temp_buf[qrcodegen_BUFFER_LEN_FOR_VERSION(MAX_VERSION)];
+static uint8_t img_data[PALETTE_SIZE + STRIDE(MAX_IMAGE_SIZE) * MAX_IMAGE_SIZE];
+static lv_img_dsc_t img_dsc;
+static char cached_text[MAX_QR_CODE_TEXT_LENGTH + 1];
+static bool cached;
+
+static void render(int modules, int scale)
+{
+    int size = (modules + 2 * QUIET_ZONE_MODULES) * scale;
+    int stride = STRIDE(size);
+    uint8_t *row;
+    bool dark;
+
+    img_dsc.header.always_zero = 0;
+    img_dsc.header.cf = LV_IMG_CF_INDEXED_1BIT;
+    img_dsc.header.w = size;
+    img_dsc.header.h = size;
+    img_dsc.data_size = PALETTE_SIZE + stride * size;
+    img_dsc.data = img_data;
+
+    lv_img_buf_set_palette(&img_dsc, 0, lv_color_white());
+    lv_img_buf_set_palette(&img_dsc, 1, lv_color_black());
+
+    memset(&img_data[PALETTE_SIZE], 0, stride * size);
+    for (int y = 0; y < modules; y++) {
+        // Draw one row of pixels per module row, then copy it to the rest of the scaled rows.
+        row = &img_data[PALETTE_SIZE + (QUIET_ZONE_MODULES + y) * scale * stride];
+        for (int x = 0; x < modules; x++) {
+            dark = qrcodegen_getModule(qr_buf, x, y);
+            for (int i = 0; dark && i < scale; i++) {
+                int px = (QUIET_ZONE_MODULES + x) * scale + i;
+
+                row[px / 8] |= 0x80 >> (px % 8);
+            }
+        }
+        for (int i = 1; i < scale; i++) {
+            memcpy(row + i * stride, row, stride);
+        }
+    }
+}
+
+const lv_img_dsc_t *qr_code_image_get(const char *text)
+{
+    uint32_t start;
+    int modules;
+
+    if (cached && strcmp(text, cached_text) == 0) {
+        return &img_dsc;
+    }
+
+    start = k_cycle_get_32();
+    cached = false;
+    if (!qrcodegen_encodeText(text, temp_buf, qr_buf, qrcodegen_Ecc_MEDIUM, qrcodegen_VERSION_MIN, MAX_VERSION,
+                              qrcodegen_Mask_AUTO, true)) {
+        LOG_ERR("Text does not fit in a version %d QR code", MAX_VERSION);
+        return NULL;
+    }
+
+    modules = qrcodegen_getSize(qr_buf);
+    // Same descriptor is reused for every text.
+    lv_img_cache_invalidate_src(&img_dsc);
+    render(modules, MAX_IMAGE_SIZE / (modules + 2 * QUIET_ZONE_MODULES));
+    strncpy(cached_text, text, sizeof(cached_text) - 1);
+    cached = true;
+
+    LOG_INF("Generated %dx%d QR code (%d px) in %d us", modules, modules, img_dsc.header.w,
+            k_cyc_to_us_floor32(k_cycle_get_32() - start));
+
+    return &img_dsc;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+*   Returns a 1 bpp QR code image of text, sized to fit inside the round
+*   display. The image is generated on first use and cached until called
+*   with a different text. Returns NULL if text does not fit in a QR code.
+*/
+const lv_img_dsc_t *qr_code_image_get(const char *text);
@@ -1,12 +1,17 @@
 #include <qr_code/qr_code_ui.h>
 #include <lvgl.h>
 
+#include "ui/utils/zsw_ui_render_stats.h"
+
 static lv_obj_t *root_page = NULL;
+static lv_obj_t *img;
 
-void qr_code_ui_show(lv_obj_t *root)
+void qr_code_ui_show(lv_obj_t *root, const lv_img_dsc_t *qr_code)
 {
     assert(root_page == NULL);
 
+    zsw_ui_render_stats_begin();
+
     // Create the root container
     root_page = lv_obj_create(root);
     // Remove the default border
@@ -17,16 +22,20 @@ void qr_code_ui_show(lv_obj_t *root)
     // then LVGL automatically makes the page scrollable and shows a scroll bar.
     // Does not loog very good on the round display.
     lv_obj_set_scrollbar_mode(root_page, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_style_bg_color(root_page, lv_color_white(), LV_PART_MAIN);
 
-    lv_obj_t *img = lv_img_create(root_page);
-#ifdef CONFIG_LV_Z_USE_FILESYSTEM
-    lv_img_set_src(img, "/lvgl_lfs/qr_code.bin");
-#else
-    LV_IMG_DECLARE(round_qr_full);
-    lv_img_set_src(img, &round_qr_full);
-#endif
+    img = lv_img_create(root_page);
     lv_obj_align(img, LV_ALIGN_CENTER, 0, 0);
-    lv_obj_set_size(img, 240, 240);
+    qr_code_ui_set_image(qr_code);
+
+    zsw_ui_render_stats_attach(root_page, "qr code");
+}
+
+void qr_code_ui_set_image(const lv_img_dsc_t *qr_code)
+{
+    if (qr_code) {
+        lv_img_set_src(img, qr_code);
+    }
 }
 
 void qr_code_ui_remove(void)
@@ -3,7 +3,8 @@
 #include <inttypes.h>
 #include <lvgl.h>
 
-void qr_code_ui_show(lv_obj_t *root);
+void qr_code_ui_show(lv_obj_t *root, const lv_img_dsc_t *qr_code);
 
-void qr_code_ui_remove(void);
+void qr_code_ui_set_image(const lv_img_dsc_t *qr_code);
 
+void qr_code_ui_remove(void);
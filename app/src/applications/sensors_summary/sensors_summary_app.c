@@ -8,6 +8,7 @@
 #include "sensors/zsw_pressure_sensor.h"
 #include "sensors/zsw_light_sensor.h"
 #include "sensors/zsw_environment_sensor.h"
+#include "sensors/zsw_sensor_history.h"
 #include "managers/zsw_app_manager.h"
 
 static void sensors_summary_app_start(lv_obj_t *root, lv_group_t *group);
@@ -28,6 +29,8 @@ static application_t app = {
 
 static lv_timer_t *refresh_timer;
 static float relative_pressure;
+static uint32_t last_env_sample_ms;
+static float last_iaq;
 
 static void sensors_summary_app_start(lv_obj_t *root, lv_group_t *group)
 {
@@ -35,6 +38,8 @@ static void sensors_summary_app_start(lv_obj_t *root, lv_group_t *group)
 
     // Set inital relative pressure.
     on_ref_set();
+    last_env_sample_ms = 0;
+    last_iaq = -1.0;
 
     // Increase ODR since we want high accuracy here.
     zsw_pressure_sensor_set_odr(BOSCH_BMP581_ODR_160_HZ);
@@ -63,17 +68,37 @@ static void timer_callback(lv_timer_t *timer)
     float pressure = 0.0;
     float humidity = 0.0;
     float light = -1.0;
-    float iaq = -1.0;
-
-    zsw_environment_sensor_get(&temperature, &humidity, &pressure);
-    zsw_environment_sensor_get_iaq(&iaq);
+    zsw_sensor_history_sample_t sample;
+
+    // Environment and light change slowly and are sampled periodically by their
+    // sensor modules, take them from the history instead of reading the sensors
+    // on every refresh. Only read directly until the first sample is there.
+    if (zsw_sensor_history_get_latest(ZSW_SENSOR_HISTORY_ENVIRONMENT, &sample) == 0) {
+        temperature = sample.values[0];
+        humidity = sample.values[1];
+        if (sample.timestamp_ms != last_env_sample_ms) {
+            last_env_sample_ms = sample.timestamp_ms;
+            zsw_environment_sensor_get_iaq(&last_iaq);
+        }
+    } else {
+        zsw_environment_sensor_get(&temperature, &humidity, &pressure);
+        zsw_environment_sensor_get_iaq(&last_iaq);
+    }
+
+    if (zsw_sensor_history_get_latest(ZSW_SENSOR_HISTORY_LIGHT, &sample) == 0) {
+        light = sample.values[0];
+    } else {
+        zsw_light_sensor_get_light(&light);
+    }
+
+    // Relative height needs every new pressure sample at the raised ODR, so the
+    // pressure sensor is still read directly.
     zsw_pressure_sensor_get_pressure(&pressure);
-    zsw_light_sensor_get_light(&light);
 
     sensors_summary_ui_set_pressure(pressure);
     sensors_summary_ui_set_temp(temperature);
     sensors_summary_ui_set_humidity(humidity);
-    sensors_summary_ui_set_iaq(iaq);
+    sensors_summary_ui_set_iaq(last_iaq);
     sensors_summary_ui_set_light(light);
     sensors_summary_ui_set_rel_height(get_relative_height_m(relative_pressure, pressure, temperature));
 }
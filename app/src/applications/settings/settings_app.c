@@ -14,6 +14,7 @@
 #include "managers/zsw_app_manager.h"
 #include "zsw_settings.h"
 #include <filesystem/zsw_rtt_flash_loader.h>
+#include <filesystem/zsw_storage_probe.h>
 #include "ui/popup/zsw_popup_window.h"
 
 LOG_MODULE_REGISTER(settings_app, CONFIG_ZSW_SETTINGS_APP_LOG_LEVEL);
@@ -33,6 +34,7 @@ static void on_clear_bonded_changed(lv_setting_value_t value, bool final);
 static void on_clear_storage_changed(lv_setting_value_t value, bool final);
 
 static void ble_pairing_work_handler(struct k_work *work);
+static void save_setting(const char *name, const void *value, size_t len);
 
 LV_IMG_DECLARE(settings);
 
@@ -200,6 +202,14 @@ static void settings_app_stop(void)
     settings_ui_remove();
 }
 
+static void save_setting(const char *name, const void *value, size_t len)
+{
+    uint32_t start = zsw_storage_probe_begin();
+
+    settings_save_one(name, value, len);
+    zsw_storage_probe_end(name, start);
+}
+
 static void on_close_settings(void)
 {
     zsw_app_manager_app_close_request(&app);
@@ -210,37 +220,37 @@ static void on_brightness_changed(lv_setting_value_t value, bool final)
     settings_app.brightness = value.item.slider;
     zsw_display_control_set_brightness(settings_app.brightness);
     if (final) {
-        settings_save_one(ZSW_SETTINGS_BRIGHTNESS, &settings_app.brightness, sizeof(settings_app.brightness));
+        save_setting(ZSW_SETTINGS_BRIGHTNESS, &settings_app.brightness, sizeof(settings_app.brightness));
     }
 }
 
 static void on_display_on_changed(lv_setting_value_t value, bool final)
 {
     settings_app.display_always_on = value.item.sw;
-    settings_save_one(ZSW_SETTINGS_DISPLAY_ALWAYS_ON, &settings_app.display_always_on,
-                      sizeof(settings_app.display_always_on));
+    save_setting(ZSW_SETTINGS_DISPLAY_ALWAYS_ON, &settings_app.display_always_on,
+                 sizeof(settings_app.display_always_on));
 }
 
 static void on_display_vib_press_changed(lv_setting_value_t value, bool final)
 {
     settings_app.vibration_on_click = value.item.sw;
-    settings_save_one(ZSW_SETTINGS_VIBRATE_ON_PRESS, &settings_app.vibration_on_click,
-                      sizeof(settings_app.vibration_on_click));
+    save_setting(ZSW_SETTINGS_VIBRATE_ON_PRESS, &settings_app.vibration_on_click,
+                 sizeof(settings_app.vibration_on_click));
 }
 
 static void on_aoa_enable_changed(lv_setting_value_t value, bool final)
 {
     settings_app.ble_aoa_enabled = value.item.sw;
     bleAoaAdvertise(settings_app.ble_aoa_tx_interval, settings_app.ble_aoa_tx_interval, settings_app.ble_aoa_enabled);
-    settings_save_one(ZSW_SETTINGS_BLE_AOA_EN, &settings_app.ble_aoa_enabled, sizeof(settings_app.ble_aoa_enabled));
+    save_setting(ZSW_SETTINGS_BLE_AOA_EN, &settings_app.ble_aoa_enabled, sizeof(settings_app.ble_aoa_enabled));
 }
 
 static void on_aoa_interval_changed(lv_setting_value_t value, bool final)
 {
     settings_app.ble_aoa_tx_interval = value.item.slider;
     if (final) {
-        settings_save_one(ZSW_SETTINGS_BLE_AOA_INT, &settings_app.ble_aoa_tx_interval,
-                          sizeof(settings_app.ble_aoa_tx_interval));
+        save_setting(ZSW_SETTINGS_BLE_AOA_INT, &settings_app.ble_aoa_tx_interval,
+                     sizeof(settings_app.ble_aoa_tx_interval));
     }
 }
 
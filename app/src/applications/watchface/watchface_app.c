@@ -40,10 +40,15 @@
 #include "sensors/zsw_pressure_sensor.h"
 #include "managers/zsw_battery_manager.h"
 #include "managers/zsw_notification_manager.h"
+#include "ui/utils/zsw_ui_transition.h"
 
 LOG_MODULE_REGISTER(watcface_app, LOG_LEVEL_WRN);
 
+#ifdef CONFIG_WATCHFACE_LAYOUTS
+#define MAX_WATCHFACES  (5 + CONFIG_WATCHFACE_LAYOUTS_MAX_NUM)
+#else
 #define MAX_WATCHFACES  5
+#endif
 
 static void zbus_ble_comm_data_callback(const struct zbus_channel *chan);
 static void zbus_accel_data_callback(const struct zbus_channel *chan);
@@ -157,6 +162,7 @@ void watchface_app_stop(void)
 
 void watchface_change(void)
 {
+    zsw_ui_transition_capture(ZSW_UI_TRANSITION_FADE);
     watchfaces[current_watchface]->remove();
     current_watchface = (current_watchface + 1) % num_watchfaces;
 
@@ -190,6 +196,7 @@ static void general_work(struct k_work *item)
             is_suspended = false;
             watchfaces[current_watchface]->show(watchface_evt_cb);
             refresh_ui();
+            zsw_ui_transition_start();
 
             __ASSERT(0 <= k_work_schedule(&clock_work.work, K_NO_WAIT), "FAIL clock_work");
             __ASSERT(0 <= k_work_schedule(&date_work.work, K_SECONDS(1)), "FAIL clock_work");
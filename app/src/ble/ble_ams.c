@@ -60,8 +60,6 @@ static void ble_ams_delayed_write_handle(struct k_work *item);
 static void ams_discover_retry_handle(struct k_work *item);
 static void music_control_event_callback(const struct zbus_channel *chan);
 
-ZBUS_CHAN_DECLARE(ble_comm_data_chan);
-
 ZBUS_CHAN_DECLARE(music_control_data_chan);
 ZBUS_OBS_DECLARE(ios_music_control_lis);
 ZBUS_CHAN_ADD_OBS(music_control_data_chan, ios_music_control_lis, 1);
@@ -191,7 +189,7 @@ static void notify_eu_cb(struct bt_ams_client *ams_c,
             memcpy(&evt_music_inf.data.data.music_info.track_name, msg_buff, notif->len);
 
             // Only publish when all music information is received, otherwise values are overwritten
-            zbus_chan_pub(&ble_comm_data_chan, &evt_music_inf, K_MSEC(250));
+            ble_comm_post_data(&evt_music_inf.data);
 
             memset(&evt_music_inf, 0, sizeof(evt_music_inf));
         }
@@ -214,7 +212,7 @@ static void notify_eu_cb(struct bt_ams_client *ams_c,
                 evt_music_state.data.data.music_state.position = (int)atof(elapsed_time);
             }
 
-            zbus_chan_pub(&ble_comm_data_chan, &evt_music_state, K_MSEC(250));
+            ble_comm_post_data(&evt_music_state.data);
         }
     }
 }
@@ -16,7 +16,6 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/byteorder.h>
-#include <zephyr/zbus/zbus.h>
 
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/conn.h>
@@ -45,8 +44,6 @@ static struct bt_gattp gattp;
 
 static atomic_t discovery_flags;
 
-static on_data_cb_t data_parsed_cb;
-
 /* Local copy to keep track of the newest arriving notifications. */
 static struct bt_ancs_evt_notif notification_latest;
 /* Local copy of the newest notification attribute. */
@@ -105,7 +102,6 @@ static void bt_ancs_write_response_handler(struct bt_ancs_client *ancs_c, uint8_
 static void gatt_discover_retry_handle(struct k_work *item);
 
 K_WORK_DELAYABLE_DEFINE(gatt_discover_retry, gatt_discover_retry_handle);
-ZBUS_CHAN_DECLARE(ble_comm_data_chan);
 
 static void enable_ancs_notifications(struct bt_ancs_client *ancs_c)
 {
@@ -423,7 +419,7 @@ static int parse_notify(const struct bt_ancs_attr *attr)
         // the last message is Negative action label, send only when all data is received;
         case ATTR_ID_NEGATIVE_ACTION_LABEL:
             cb.type = BLE_COMM_DATA_TYPE_NOTIFY;
-            data_parsed_cb(&cb);
+            ble_comm_post_data(&cb);
             memset(&cb, 0, sizeof(cb));
             break;
 
@@ -453,7 +449,7 @@ static void bt_ancs_notification_source_handler(struct bt_ancs_client *ancs_c,
 
             LOG_DBG("Remove notification %d", evt_notif_rem.data.data.notify_remove.id);
 
-            zbus_chan_pub(&ble_comm_data_chan, &evt_notif_rem, K_MSEC(250));
+            ble_comm_post_data(&evt_notif_rem.data);
 
             return;
         }
@@ -498,7 +494,7 @@ static int gattp_init(void)
 }
 
 
-int ble_ancs_init(on_data_cb_t data_cb)
+int ble_ancs_init(void)
 {
     int err = bt_ancs_client_init(&ancs_c);
     if (err) {
@@ -584,8 +580,6 @@ int ble_ancs_init(on_data_cb_t data_cb)
         return err;
     }
 
-    data_parsed_cb = data_cb;
-
     LOG_INF("Started Apple Notification Center Service client");
 
     return err;
@@ -3,4 +3,4 @@
 #include <zephyr/kernel.h>
 #include "ble/ble_comm.h"
 
-int ble_ancs_init(on_data_cb_t data_cb);
\ No newline at end of file
+int ble_ancs_init(void);
\ No newline at end of file
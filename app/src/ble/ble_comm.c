@@ -32,6 +32,10 @@
 #include "ble/ble_transport.h"
 #include "events/ble_data_event.h"
 #include "events/music_event.h"
+#include "events/perf_profile_event.h"
+#include "managers/zsw_perf_profile.h"
+#include "zsw_cycle_prof.h"
+#include "zsw_ram_code.h"
 
 #include <bluetooth/services/ams_client.h>
 #include <bluetooth/services/ancs_client.h>
@@ -45,6 +49,10 @@ LOG_MODULE_REGISTER(ble_comm, CONFIG_ZSW_BLE_LOG_LEVEL);
 
 #define MAX_GB_PACKET_LENGTH                   1000
 
+// Notification strings are copied into the queued event, anything longer than
+// what the notification manager stores is not worth copying.
+#define RX_EVENT_NOTIFY_FIELD_LEN              64
+
 ZBUS_CHAN_DECLARE(ble_comm_data_chan);
 
 typedef enum parse_state {
@@ -53,18 +61,34 @@ typedef enum parse_state {
     PARSE_STATE_DONE,
 } parse_state_t;
 
+typedef enum rx_event_notify_field {
+    RX_EVENT_NOTIFY_BODY,
+    RX_EVENT_NOTIFY_SENDER,
+    RX_EVENT_NOTIFY_TITLE,
+    RX_EVENT_NOTIFY_SRC,
+    RX_EVENT_NOTIFY_SUBJECT,
+    RX_EVENT_NOTIFY_NUM_FIELDS,
+} rx_event_notify_field_t;
+
+typedef struct rx_event {
+    ble_comm_cb_data_t data;
+    char notify_strings[RX_EVENT_NOTIFY_NUM_FIELDS][RX_EVENT_NOTIFY_FIELD_LEN];
+} rx_event_t;
+
 static char *extract_value_str(char *key, char *data, int *value_len);
 static int parse_data(char *data, int len);
 static void parse_time(char *data);
 static void parse_remote_control(char *data, int len);
-static void send_ble_data_event(ble_comm_cb_data_t *data);
+static void ble_event_thread(void *, void *, void *);
 
 static void connected(struct bt_conn *conn, uint8_t err);
 static void disconnected(struct bt_conn *conn, uint8_t reason);
 static void param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency, uint16_t timeout);
 static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data, uint16_t len);
+static void handle_rx_data(const uint8_t *const data, uint16_t len);
 static void update_conn_interval_handler(struct k_work *item);
 static void music_control_event_callback(const struct zbus_channel *chan);
+static void perf_profile_event_callback(const struct zbus_channel *chan);
 
 BT_CONN_CB_DEFINE(conn_callbacks) = {
     .connected    = connected,
@@ -89,9 +113,16 @@ static const struct bt_data ad_nus[] = {
 
 K_WORK_DELAYABLE_DEFINE(conn_interval_work, update_conn_interval_handler);
 
+K_THREAD_DEFINE(ble_event_tid, CONFIG_ZSW_BLE_EVENT_THREAD_STACK_SIZE, ble_event_thread, NULL, NULL, NULL,
+                CONFIG_ZSW_BLE_EVENT_THREAD_PRIORITY, 0, 0);
+K_MSGQ_DEFINE(ble_event_msgq, sizeof(rx_event_t), CONFIG_ZSW_BLE_EVENT_QUEUE_SIZE, 4);
+
 ZBUS_CHAN_DECLARE(music_control_data_chan);
 ZBUS_LISTENER_DEFINE(android_music_control_lis, music_control_event_callback);
 
+ZBUS_CHAN_DECLARE(perf_profile_data_chan);
+ZBUS_LISTENER_DEFINE(ble_comm_perf_profile_lis, perf_profile_event_callback);
+
 static struct bt_conn *current_conn;
 static uint32_t max_send_len;
 static uint8_t receive_buf[MAX_GB_PACKET_LENGTH];
@@ -101,6 +132,11 @@ static parse_state_t parse_state = WAIT_GB;
 
 static on_data_cb_t data_parsed_cb;
 
+static ble_comm_rx_stats_t rx_stats;
+// Staging copy for ble_comm_post_data, too big for the Bluetooth RX thread stack.
+static rx_event_t post_evt;
+static struct k_spinlock post_lock;
+
 static int pairing_enabled;
 
 static void music_control_event_callback(const struct zbus_channel *chan)
@@ -199,6 +235,15 @@ static struct bt_conn_auth_info_cb auth_cb_info = {
     .pairing_failed = pairing_failed,
 };
 
+static void perf_profile_event_callback(const struct zbus_channel *chan)
+{
+    // Drop any short connection interval requested before entering the profile.
+    if (current_conn && !zsw_perf_profile_get_policy()->ble_short_conn_interval) {
+        k_work_cancel_delayable(&conn_interval_work);
+        ble_comm_long_connection_interval();
+    }
+}
+
 int ble_comm_init(on_data_cb_t data_cb)
 {
     bt_conn_auth_cb_register(&auth_cb_display);
@@ -213,6 +258,8 @@ int ble_comm_init(on_data_cb_t data_cb)
     }
     data_parsed_cb = data_cb;
 
+    zbus_chan_add_obs(&perf_profile_data_chan, &ble_comm_perf_profile_lis, K_MSEC(100));
+
     struct bt_le_adv_param adv_param = {
         .options = BT_LE_ADV_OPT_CONNECTABLE | BT_LE_ADV_OPT_USE_NAME,
         .interval_min = BT_GAP_ADV_SLOW_INT_MIN,
@@ -261,6 +308,11 @@ int ble_comm_short_connection_interval(void)
         .timeout = CONFIG_BT_PERIPHERAL_PREF_TIMEOUT,
     };
 
+    if (!zsw_perf_profile_get_policy()->ble_short_conn_interval) {
+        LOG_DBG("Short connection interval not allowed in current profile");
+        return ble_comm_long_connection_interval();
+    }
+
     // If someone explicitly requested short connection interval,
     // don't change it back.
     k_work_cancel_delayable(&conn_interval_work);
@@ -365,6 +417,8 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
     bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
 
     LOG_INF("Disconnected: %s (reason %u)", addr, reason);
+    LOG_INF("RX events: %d posted, %d dropped, max %d queued, longest RX callback %d us", rx_stats.num_posted,
+            rx_stats.num_dropped, rx_stats.max_queued, rx_stats.max_rx_us);
 
     if (current_conn) {
         k_work_cancel_delayable(&conn_interval_work);
@@ -380,11 +434,25 @@ static void param_updated(struct bt_conn *conn, uint16_t interval, uint16_t late
 
 static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data, uint16_t len)
 {
+    uint32_t start = k_cycle_get_32();
+    uint32_t duration_us;
+
+    handle_rx_data(data, len);
+
+    duration_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    rx_stats.max_rx_us = MAX(rx_stats.max_rx_us, duration_us);
+}
+
+static ZSW_HOT_FUNC void handle_rx_data(const uint8_t *const data, uint16_t len)
+{
+    uint64_t prof_start = zsw_cycle_prof_begin();
+
     LOG_HEXDUMP_DBG(data, len, "RX");
 
     if (strncmp("Control:", data, MIN(strlen("Control:"), len)) == 0) {
         char *time_start = strstr(data, "Control:");
-        return parse_remote_control(time_start + strlen("Control:"), len - strlen("Control:"));
+        parse_remote_control(time_start + strlen("Control:"), len - strlen("Control:"));
+        return;
     }
 
     char *gb_start = strstr(data, "GB(");
@@ -453,10 +521,13 @@ static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data, uint1
             LOG_WRN("Unhandled state");
             break;
     }
+    zsw_cycle_prof_end(ZSW_CYCLE_PROF_BLE_RX, prof_start);
     if (parse_state == PARSE_STATE_DONE) {
         parse_state = WAIT_GB;
         LOG_DBG("%s", receive_buf);
+        prof_start = zsw_cycle_prof_begin();
         parse_data(receive_buf, parsed_data_index);
+        zsw_cycle_prof_end(ZSW_CYCLE_PROF_GB_PARSE, prof_start);
     }
 }
 
@@ -472,14 +543,14 @@ static void parse_time(char *start_time)
         cb.data.notify.id = strtol(start_time, &end_time, 10);
         if (start_time != end_time && errno == 0) {
             cb.type = BLE_COMM_DATA_TYPE_SET_TIME;
-            send_ble_data_event(&cb);
+            ble_comm_post_data(&cb);
         } else {
             LOG_WRN("Failed parsing time");
         }
     }
 }
 
-static char *extract_value_str(char *key, char *data, int *value_len)
+static ZSW_HOT_FUNC char *extract_value_str(char *key, char *data, int *value_len)
 {
     bool base64 = false;
     char *start;
@@ -563,11 +634,12 @@ static int32_t extract_value_int32(char *key, char *data)
 }
 
 
-static void convert_to_encoded_text(char *data, int len, char *out_data, int out_buf_len)
+static ZSW_HOT_FUNC void convert_to_encoded_text(char *data, int len, char *out_data, int out_buf_len)
 {
     int i = 0, j = 0;
     // https://www.utf8-chartable.de/
-    uint8_t basic_latin_utf16_to_utf8_table[0x80][3] = {
+    // Static so the table isn't copied to the stack on every message.
+    static const uint8_t basic_latin_utf16_to_utf8_table[0x80][3] = {
         // utf-16 => 2 byte utf-8
         {0x80, 0xc2, 0x80},
         {0x81, 0xc2, 0x81},
@@ -774,7 +846,7 @@ static int parse_notify(char *data, int len)
         cb.data.notify.body[cb.data.notify.body_len] = '\0';
     }
 
-    data_parsed_cb(&cb);
+    ble_comm_post_data(&cb);
 
     return 0;
 }
@@ -786,7 +858,7 @@ static int parse_notify_delete(char *data, int len)
 
     cb.type = BLE_COMM_DATA_TYPE_NOTIFY_REMOVE;
     cb.data.notify.id = extract_value_uint32("\"id\":", data);
-    send_ble_data_event(&cb);
+    ble_comm_post_data(&cb);
     return 0;
 }
 
@@ -812,7 +884,7 @@ static int parse_weather(char *data, int len)
     // App sends temperature in Kelvin
     temperature = temperature_k - 273.15f;
     cb.data.weather.temperature_c = (int8_t)roundf(temperature);
-    send_ble_data_event(&cb);
+    ble_comm_post_data(&cb);
     return 0;
 }
 
@@ -835,7 +907,7 @@ static int parse_musicinfo(char *data, int len)
     temp_value = extract_value_str("\"track\":", data, &temp_len);
     strncpy(cb.data.music_info.track_name, temp_value, MIN(temp_len, MAX_MUSIC_FIELD_LENGTH));
 
-    send_ble_data_event(&cb);
+    ble_comm_post_data(&cb);
 
     return 0;
 }
@@ -860,12 +932,32 @@ static int parse_musicstate(char *data, int len)
         cb.data.music_state.playing = false;
     }
 
-    send_ble_data_event(&cb);
+    ble_comm_post_data(&cb);
+
+    return 0;
+}
+
+static int parse_qr_code(char *data, int len)
+{
+    // {t:"qrcode",text:"https://github.com/jakkra/ZSWatch"}
+    char *temp_value;
+    int temp_len;
+    ble_comm_cb_data_t cb;
+    memset(&cb, 0, sizeof(cb));
+
+    temp_value = extract_value_str("\"text\":", data, &temp_len);
+    if (temp_value == NULL || temp_len == 0) {
+        return -EINVAL;
+    }
+
+    cb.type = BLE_COMM_DATA_TYPE_QR_CODE;
+    strncpy(cb.data.qr_code.text, temp_value, MIN(temp_len, MAX_QR_CODE_TEXT_LENGTH));
+    ble_comm_post_data(&cb);
 
     return 0;
 }
 
-static int parse_data(char *data, int len)
+static ZSW_HOT_FUNC int parse_data(char *data, int len)
 {
     int type_len;
     char *type;
@@ -901,6 +993,10 @@ static int parse_data(char *data, int len)
         return parse_musicstate(data, len);
     }
 
+    if (strlen("qrcode") == type_len && strncmp(type, "qrcode", type_len) == 0) {
+        return parse_qr_code(data, len);
+    }
+
     return 0;
 }
 
@@ -918,13 +1014,92 @@ static void parse_remote_control(char *data, int len)
 
     cb.type = BLE_COMM_DATA_TYPE_REMOTE_CONTROL;
     cb.data.remote_control.button = button;
-    send_ble_data_event(&cb);
+    ble_comm_post_data(&cb);
 }
 
-static void send_ble_data_event(ble_comm_cb_data_t *data)
+static char *copy_notify_field(rx_event_t *evt, rx_event_notify_field_t field, const char *str, int *len)
 {
-    struct ble_data_event evt;
-    memcpy(&evt.data, data, sizeof(ble_comm_cb_data_t));
+    if (!str) {
+        *len = 0;
+        return NULL;
+    }
+
+    *len = MIN(*len, RX_EVENT_NOTIFY_FIELD_LEN - 1);
+    memcpy(evt->notify_strings[field], str, *len);
+    evt->notify_strings[field][*len] = '\0';
 
-    zbus_chan_pub(&ble_comm_data_chan, &evt, K_MSEC(250));
-}
\ No newline at end of file
+    return evt->notify_strings[field];
+}
+
+static void fixup_notify_fields(rx_event_t *evt)
+{
+    // Pointers were set up before the event was copied through the queue,
+    // point them at the strings in this copy.
+    ble_comm_notify_t *notify = &evt->data.data.notify;
+
+    notify->body = notify->body ? evt->notify_strings[RX_EVENT_NOTIFY_BODY] : NULL;
+    notify->sender = notify->sender ? evt->notify_strings[RX_EVENT_NOTIFY_SENDER] : NULL;
+    notify->title = notify->title ? evt->notify_strings[RX_EVENT_NOTIFY_TITLE] : NULL;
+    notify->src = notify->src ? evt->notify_strings[RX_EVENT_NOTIFY_SRC] : NULL;
+    notify->subject = notify->subject ? evt->notify_strings[RX_EVENT_NOTIFY_SUBJECT] : NULL;
+}
+
+static void ble_event_thread(void *, void *, void *)
+{
+    rx_event_t evt;
+    struct ble_data_event zbus_evt;
+
+    while (1) {
+        k_msgq_get(&ble_event_msgq, &evt, K_FOREVER);
+
+        if (evt.data.type == BLE_COMM_DATA_TYPE_NOTIFY) {
+            fixup_notify_fields(&evt);
+            if (data_parsed_cb) {
+                data_parsed_cb(&evt.data);
+            }
+        } else {
+            memcpy(&zbus_evt.data, &evt.data, sizeof(ble_comm_cb_data_t));
+            zbus_chan_pub(&ble_comm_data_chan, &zbus_evt, K_MSEC(250));
+        }
+    }
+}
+
+int ble_comm_post_data(const ble_comm_cb_data_t *data)
+{
+    int ret;
+    k_spinlock_key_t key = k_spin_lock(&post_lock);
+
+    post_evt.data = *data;
+    if (data->type == BLE_COMM_DATA_TYPE_NOTIFY) {
+        ble_comm_notify_t *notify = &post_evt.data.data.notify;
+
+        notify->body = copy_notify_field(&post_evt, RX_EVENT_NOTIFY_BODY, notify->body, &notify->body_len);
+        notify->sender = copy_notify_field(&post_evt, RX_EVENT_NOTIFY_SENDER, notify->sender, &notify->sender_len);
+        notify->title = copy_notify_field(&post_evt, RX_EVENT_NOTIFY_TITLE, notify->title, &notify->title_len);
+        notify->src = copy_notify_field(&post_evt, RX_EVENT_NOTIFY_SRC, notify->src, &notify->src_len);
+        notify->subject = copy_notify_field(&post_evt, RX_EVENT_NOTIFY_SUBJECT, notify->subject,
+                                            &notify->subject_len);
+    }
+
+    ret = k_msgq_put(&ble_event_msgq, &post_evt, K_NO_WAIT);
+    if (ret == 0) {
+        rx_stats.num_posted++;
+        rx_stats.max_queued = MAX(rx_stats.max_queued, k_msgq_num_used_get(&ble_event_msgq));
+    } else {
+        rx_stats.num_dropped++;
+    }
+
+    k_spin_unlock(&post_lock, key);
+
+    if (ret != 0) {
+        LOG_WRN("BLE event queue full, dropped type %d (%d dropped in total)", data->type, rx_stats.num_dropped);
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+void ble_comm_get_rx_stats(ble_comm_rx_stats_t *stats)
+{
+    *stats = rx_stats;
+}
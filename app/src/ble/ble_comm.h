@@ -21,6 +21,7 @@
 
 #define MAX_MUSIC_FIELD_LENGTH          100
 #define MAX_WEATHER_REPORT_TEXT_LENGTH  25
+#define MAX_QR_CODE_TEXT_LENGTH         100
 
 typedef enum ble_comm_data_type {
     BLE_COMM_DATA_TYPE_NOTIFY,
@@ -30,6 +31,7 @@ typedef enum ble_comm_data_type {
     BLE_COMM_DATA_TYPE_MUSIC_INFO,
     BLE_COMM_DATA_TYPE_MUSIC_STATE,
     BLE_COMM_DATA_TYPE_REMOTE_CONTROL,
+    BLE_COMM_DATA_TYPE_QR_CODE,
     BLE_COMM_DATA_TYPE_EMPTY
 } ble_comm_data_type_t;
 
@@ -84,6 +86,10 @@ typedef struct ble_comm_remote_control {
     int button;
 } ble_comm_remote_control_t;
 
+typedef struct ble_comm_qr_code {
+    char text[MAX_QR_CODE_TEXT_LENGTH + 1];
+} ble_comm_qr_code_t;
+
 typedef struct ble_comm_cb_data {
     ble_comm_data_type_t type;
     union {
@@ -94,11 +100,20 @@ typedef struct ble_comm_cb_data {
         ble_comm_music_info_t music_info;
         ble_comm_music_state_t music_state;
         ble_comm_remote_control_t remote_control;
+        ble_comm_qr_code_t qr_code;
     } data;
 } ble_comm_cb_data_t;
 
 typedef void(*on_data_cb_t)(ble_comm_cb_data_t *data);
 
+typedef struct ble_comm_rx_stats {
+    uint32_t num_posted;
+    uint32_t num_dropped;
+    uint32_t max_queued;
+    // Longest time spent in the Gadgetbridge receive callback, i.e. the Bluetooth RX thread stall.
+    uint32_t max_rx_us;
+} ble_comm_rx_stats_t;
+
 /** @brief
  *  @return 0 when successful
 */
@@ -111,6 +126,19 @@ int ble_comm_init(on_data_cb_t data_cb);
 */
 int ble_comm_send(uint8_t *data, uint16_t len);
 
+/** @brief Queue received data for delivery from the BLE event thread, never blocks.
+ *         Notifications go to the callback given to ble_comm_init, everything else
+ *         is published on ble_comm_data_chan.
+ *  @param data Copied, notification strings are truncated to 63 characters.
+ *  @return     0 when successful, -ENOMEM if the queue is full and the data was dropped
+*/
+int ble_comm_post_data(const ble_comm_cb_data_t *data);
+
+/** @brief
+ *  @param stats Filled with the receive path statistics since boot
+*/
+void ble_comm_get_rx_stats(ble_comm_rx_stats_t *stats);
+
 /** @brief
  *  @param pairable
  *  @return         0 when successful
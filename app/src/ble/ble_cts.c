@@ -16,7 +16,6 @@
 #include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/bluetooth/gatt.h>
-#include <zephyr/zbus/zbus.h>
 
 #include <bluetooth/gatt_dm.h>
 #include <bluetooth/services/cts_client.h>
@@ -26,7 +25,6 @@
 #include "events/ble_data_event.h"
 
 LOG_MODULE_REGISTER(ble_cts, LOG_LEVEL_WRN);
-ZBUS_CHAN_DECLARE(ble_comm_data_chan);
 
 static struct bt_cts_client cts_c;
 
@@ -99,7 +97,7 @@ void publish_time_event(struct bt_cts_current_time *current_time)
 
     LOG_DBG("EPOCH %d", evt_time_inf.data.data.time.seconds);
 
-    zbus_chan_pub(&ble_comm_data_chan, &evt_time_inf, K_MSEC(250));
+    ble_comm_post_data(&evt_time_inf.data);
 }
 
 static void notify_current_time_cb(struct bt_cts_client *cts_c,
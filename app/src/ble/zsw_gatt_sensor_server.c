@@ -31,6 +31,7 @@
 #include "sensors/zsw_imu.h"
 #include "sensors/zsw_magnetometer.h"
 #include "sensors/zsw_environment_sensor.h"
+#include "managers/zsw_perf_profile.h"
 
 LOG_MODULE_REGISTER(zsw_gatt_sensor_server, CONFIG_ZSW_BLE_LOG_LEVEL);
 
@@ -194,6 +195,11 @@ static void zbus_periodic_fast_callback(const struct zbus_channel *chan)
     float humidity = 0.0;
     float temperature = 0.0;
     uint8_t buf[CONFIG_BT_L2CAP_TX_MTU];
+    static uint32_t num_periods;
+
+    if (num_periods++ % zsw_perf_profile_get_policy()->gatt_sensor_stream_divider != 0) {
+        return;
+    }
 
     f_ptr = (float *)buf;
 
@@ -0,0 +1,150 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+#include "lvgl.h"
+#include "drivers/zsw_boot_splash.h"
+#include "drivers/zsw_display_control.h"
+#include "filesystem/zsw_lvgl_spi_decoder.h"
+
+LOG_MODULE_REGISTER(boot_splash, LOG_LEVEL_INF);
+
+// Rows streamed from flash per display write.
+#define SPLASH_CHUNK_ROWS   8
+#define SPLASH_MAX_WIDTH    240
+#define SPLASH_PIXEL_SIZE   2
+
+static const struct device *display_dev = DEVICE_DT_GET_OR_NULL(DT_CHOSEN(zephyr_display));
+
+static uint8_t chunk_buf[SPLASH_MAX_WIDTH * SPLASH_CHUNK_ROWS * SPLASH_PIXEL_SIZE];
+static uint32_t first_pixel_ms;
+
+static int write_rows(uint16_t y, uint16_t rows, uint16_t width)
+{
+    struct display_buffer_descriptor desc = {
+        .buf_size = width * rows * SPLASH_PIXEL_SIZE,
+        .width = width,
+        .height = rows,
+        .pitch = width,
+    };
+
+    return display_write(display_dev, 0, y, &desc, chunk_buf);
+}
+
+static int stream_splash(uint32_t offset, const lv_img_header_t *header, const struct display_capabilities *caps)
+{
+    int rc;
+    uint16_t x_start = (caps->x_resolution - header->w) / 2;
+    uint16_t y_start = (caps->y_resolution - header->h) / 2;
+    uint32_t row_len = header->w * SPLASH_PIXEL_SIZE;
+    uint32_t line_len = caps->x_resolution * SPLASH_PIXEL_SIZE;
+
+    // Full width rows so the borders around a smaller image are cleared too,
+    // the panel RAM holds random data after power on.
+    for (uint16_t y = 0; y < caps->y_resolution; y += SPLASH_CHUNK_ROWS) {
+        uint16_t rows = MIN(SPLASH_CHUNK_ROWS, caps->y_resolution - y);
+
+        memset(chunk_buf, 0, sizeof(chunk_buf));
+        for (uint16_t row = 0; row < rows; row++) {
+            uint16_t img_row = y + row - y_start;
+
+            if (y + row < y_start || img_row >= header->h) {
+                continue;
+            }
+            rc = zsw_decoder_read_raw(offset + img_row * row_len, &chunk_buf[row * line_len + x_start * SPLASH_PIXEL_SIZE],
+                                      row_len);
+            if (rc != 0) {
+                return rc;
+            }
+        }
+
+        rc = write_rows(y, rows, caps->x_resolution);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t zsw_boot_splash_get_first_pixel_ms(void)
+{
+    return first_pixel_ms;
+}
+
+static int zsw_boot_splash_init(void)
+{
+    int rc;
+    uint32_t offset;
+    uint32_t len;
+    uint32_t start_ms;
+    lv_img_header_t header;
+    struct display_capabilities caps;
+
+    start_ms = k_uptime_get_32();
+
+    if (!device_is_ready(display_dev)) {
+        return 0;
+    }
+
+    display_get_capabilities(display_dev, &caps);
+    if (caps.current_pixel_format != PIXEL_FORMAT_RGB_565 || caps.x_resolution > SPLASH_MAX_WIDTH) {
+        LOG_WRN("Display format not supported for boot splash");
+        return 0;
+    }
+
+    rc = zsw_decoder_get_file_location(CONFIG_ZSW_BOOT_SPLASH_FILE, &offset, &len);
+    if (rc != 0) {
+        LOG_DBG("No boot splash: %d", rc);
+        return 0;
+    }
+
+    rc = zsw_decoder_read_raw(offset, &header, sizeof(header));
+    if (rc != 0) {
+        return 0;
+    }
+
+    if (header.cf != LV_IMG_CF_TRUE_COLOR || header.w > caps.x_resolution || header.h > caps.y_resolution ||
+        len < sizeof(header) + header.w * header.h * SPLASH_PIXEL_SIZE) {
+        LOG_WRN("%s must be a true color image of max %dx%d", CONFIG_ZSW_BOOT_SPLASH_FILE, caps.x_resolution,
+                caps.y_resolution);
+        return 0;
+    }
+
+    rc = stream_splash(offset + sizeof(header), &header, &caps);
+    if (rc != 0) {
+        LOG_ERR("Failed streaming boot splash: %d", rc);
+        return 0;
+    }
+
+    display_blanking_off(display_dev);
+    // Brightness setting is not loaded yet, the display control applies
+    // it when LVGL takes over and draws on top of the splash.
+    zsw_display_control_set_brightness(zsw_display_control_get_brightness());
+
+    first_pixel_ms = k_uptime_get_32();
+    LOG_INF("Boot splash shown %d ms after kernel start (%d ms streaming)", first_pixel_ms, first_pixel_ms - start_ms);
+
+    return 0;
+}
+
+SYS_INIT(zsw_boot_splash_init, POST_KERNEL, CONFIG_ZSW_BOOT_SPLASH_INIT_PRIORITY);
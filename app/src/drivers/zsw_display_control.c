@@ -24,11 +24,21 @@
 #include <zephyr/drivers/regulator.h>
 #include <zephyr/drivers/display.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
 #include "lvgl.h"
+#include "managers/zsw_perf_profile.h"
+#include "managers/zsw_mem_pressure.h"
+#include "zsw_cycle_prof.h"
 
 LOG_MODULE_REGISTER(display_control, LOG_LEVEL_WRN);
 
 static void lvgl_render(struct k_work *item);
+static void zbus_perf_profile_callback(const struct zbus_channel *chan);
+#ifdef CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER
+static void apply_render_mode(void);
+static void render_monitor_cb(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px);
+static void mem_pressure_shed(zsw_mem_pressure_level_t level);
+#endif
 
 typedef enum display_state {
     DISPLAY_STATE_AWAKE,
@@ -45,11 +55,38 @@ K_WORK_DELAYABLE_DEFINE(lvgl_work, lvgl_render);
 
 K_MUTEX_DEFINE(display_mutex);
 
+ZBUS_CHAN_DECLARE(perf_profile_data_chan);
+ZBUS_LISTENER_DEFINE(zsw_display_control_perf_profile_lis, zbus_perf_profile_callback);
+
 static struct k_work_sync canel_work_sync;
 static display_state_t display_state;
 static bool first_render_since_poweron;
 static uint8_t last_brightness = 30;
 
+#ifdef CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER
+typedef struct render_stats {
+    uint32_t num_frames;
+    uint64_t total_time_ms;
+    uint32_t max_time_ms;
+    uint32_t peak_ram_bytes;
+} render_stats_t;
+
+static lv_disp_draw_buf_t full_frame_draw_buf;
+static lv_disp_draw_buf_t *partial_draw_buf;
+static lv_color_t *full_frame_buf;
+static zsw_display_render_mode_t render_mode;
+static zsw_display_render_mode_t requested_render_mode;
+static render_stats_t render_stats[ZSW_DISPLAY_RENDER_MODE_NUM];
+
+// The app keeps working in partial mode, only slower, so this goes late.
+static zsw_mem_pressure_handler_t mem_pressure_handler = {
+    .name = "full_frame_buf",
+    .level = ZSW_MEM_PRESSURE_CRITICAL,
+    .priority = 20,
+    .shed = mem_pressure_shed,
+};
+#endif
+
 void zsw_display_control_init(void)
 {
     if (!device_is_ready(display_dev)) {
@@ -66,6 +103,17 @@ void zsw_display_control_init(void)
     }
 
     display_state = DISPLAY_STATE_SLEEPING;
+
+    zbus_chan_add_obs(&perf_profile_data_chan, &zsw_display_control_perf_profile_lis, K_MSEC(100));
+    zsw_cycle_prof_attach_lvgl();
+
+#ifdef CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp) {
+        disp->driver->monitor_cb = render_monitor_cb;
+    }
+    zsw_mem_pressure_register(&mem_pressure_handler);
+#endif
 }
 
 int zsw_display_control_sleep_ctrl(bool on)
@@ -212,7 +260,7 @@ void zsw_display_control_set_brightness(uint8_t percent)
 
     // TODO this is not correct, the FAN5622SX LED driver have 32 different brightness levels
     // and we need to take that into consideration when choosing pwm period and pulse width.
-    uint32_t pulse_width = percent * (display_blk.period / 100);
+    uint32_t pulse_width = MIN(percent, zsw_perf_profile_get_policy()->max_brightness) * (display_blk.period / 100);
 
     if (display_state != DISPLAY_STATE_AWAKE && percent != 0) {
         LOG_WRN("Setting brightness when display is off may cause issues with active/inactive state, make sure you know what you are doing.");
@@ -227,9 +275,132 @@ void zsw_display_control_set_brightness(uint8_t percent)
     k_mutex_unlock(&display_mutex);
 }
 
+static void zbus_perf_profile_callback(const struct zbus_channel *chan)
+{
+    // Apply the new brightness ceiling, requested brightness is kept in last_brightness.
+    if (display_state == DISPLAY_STATE_AWAKE) {
+        zsw_display_control_set_brightness(last_brightness);
+    }
+}
+
+int zsw_display_control_set_render_mode(zsw_display_render_mode_t mode)
+{
+#ifdef CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER
+    __ASSERT(mode < ZSW_DISPLAY_RENDER_MODE_NUM, "Invalid render mode: %d", mode);
+    if (mode == ZSW_DISPLAY_RENDER_MODE_FULL_FRAME && zsw_mem_pressure_get_level() != ZSW_MEM_PRESSURE_NONE) {
+        requested_render_mode = ZSW_DISPLAY_RENDER_MODE_PARTIAL;
+        return -ENOMEM;
+    }
+    // Draw buffers can only be swapped between two LVGL refreshes, see lvgl_render.
+    requested_render_mode = mode;
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
+
+zsw_display_render_mode_t zsw_display_control_get_render_mode(void)
+{
+#ifdef CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER
+    return render_mode;
+#else
+    return ZSW_DISPLAY_RENDER_MODE_PARTIAL;
+#endif
+}
+
+void zsw_display_control_get_render_stats(zsw_display_render_mode_t mode, zsw_display_render_stats_t *stats)
+{
+    memset(stats, 0, sizeof(zsw_display_render_stats_t));
+#ifdef CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER
+    __ASSERT(mode < ZSW_DISPLAY_RENDER_MODE_NUM, "Invalid render mode: %d", mode);
+    stats->num_frames = render_stats[mode].num_frames;
+    stats->max_frame_time_ms = render_stats[mode].max_time_ms;
+    stats->peak_ram_bytes = render_stats[mode].peak_ram_bytes;
+    if (render_stats[mode].num_frames > 0) {
+        stats->avg_frame_time_ms = render_stats[mode].total_time_ms / render_stats[mode].num_frames;
+    }
+#endif
+}
+
+#ifdef CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER
+static uint32_t draw_buf_size_bytes(const lv_disp_draw_buf_t *draw_buf)
+{
+    return draw_buf->size * sizeof(lv_color_t) * (draw_buf->buf2 ? 2 : 1);
+}
+
+static void apply_render_mode(void)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    uint32_t num_pixels;
+
+    if (!disp || requested_render_mode == render_mode) {
+        return;
+    }
+
+    // The flush thread in the LVGL module may still be sending the last
+    // rendered area over SPI, the buffer can't be replaced until it's done.
+    // Same wait as LVGL does itself before reusing a draw buffer.
+    while (disp->driver->draw_buf->flushing) {
+        if (disp->driver->wait_cb) {
+            disp->driver->wait_cb(disp->driver);
+        } else {
+            k_yield();
+        }
+    }
+
+    if (requested_render_mode == ZSW_DISPLAY_RENDER_MODE_FULL_FRAME) {
+        num_pixels = lv_disp_get_hor_res(disp) * lv_disp_get_ver_res(disp);
+        full_frame_buf = k_malloc(num_pixels * sizeof(lv_color_t));
+        if (!full_frame_buf) {
+            zsw_mem_pressure_report_alloc_failure("full frame buffer", num_pixels * sizeof(lv_color_t));
+            requested_render_mode = ZSW_DISPLAY_RENDER_MODE_PARTIAL;
+            return;
+        }
+        partial_draw_buf = disp->driver->draw_buf;
+        lv_disp_draw_buf_init(&full_frame_draw_buf, full_frame_buf, NULL, num_pixels);
+        disp->driver->draw_buf = &full_frame_draw_buf;
+    } else {
+        disp->driver->draw_buf = partial_draw_buf;
+        k_free(full_frame_buf);
+        full_frame_buf = NULL;
+    }
+
+    render_mode = requested_render_mode;
+    LOG_DBG("Render mode: %s", render_mode == ZSW_DISPLAY_RENDER_MODE_FULL_FRAME ? "full frame" : "partial");
+}
+
+static void mem_pressure_shed(zsw_mem_pressure_level_t level)
+{
+    // Called from the LVGL thread, so the buffer can be swapped right away.
+    requested_render_mode = ZSW_DISPLAY_RENDER_MODE_PARTIAL;
+    apply_render_mode();
+}
+
+static void render_monitor_cb(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
+{
+    render_stats_t *stats = &render_stats[render_mode];
+    lv_mem_monitor_t mem_mon;
+    uint32_t ram_bytes;
+
+    lv_mem_monitor(&mem_mon);
+    ram_bytes = draw_buf_size_bytes(disp_drv->draw_buf) + mem_mon.max_used;
+
+    stats->num_frames++;
+    stats->total_time_ms += time;
+    stats->max_time_ms = MAX(stats->max_time_ms, time);
+    stats->peak_ram_bytes = MAX(stats->peak_ram_bytes, ram_bytes);
+}
+#endif
+
 static void lvgl_render(struct k_work *item)
 {
+#ifdef CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER
+    apply_render_mode();
+#endif
+    uint64_t prof_start = zsw_cycle_prof_begin();
     const int64_t next_update_in_ms = lv_task_handler();
+
+    zsw_cycle_prof_end(ZSW_CYCLE_PROF_LVGL_REFRESH, prof_start);
     if (first_render_since_poweron) {
         zsw_display_control_set_brightness(last_brightness);
         first_render_since_poweron = false;
@@ -20,9 +20,42 @@
 #include <inttypes.h>
 #include <stdbool.h>
 
+typedef enum zsw_display_render_mode_t {
+    ZSW_DISPLAY_RENDER_MODE_PARTIAL,
+    ZSW_DISPLAY_RENDER_MODE_FULL_FRAME,
+    ZSW_DISPLAY_RENDER_MODE_NUM,
+} zsw_display_render_mode_t;
+
+typedef struct zsw_display_render_stats_t {
+    uint32_t num_frames;
+    uint32_t avg_frame_time_ms;
+    uint32_t max_frame_time_ms;
+    uint32_t peak_ram_bytes;
+} zsw_display_render_stats_t;
+
 void zsw_display_control_init(void);
 int zsw_display_control_sleep_ctrl(bool on);
 int zsw_display_control_pwr_ctrl(bool on);
 void zsw_display_control_set_brightness(uint8_t percent);
 uint8_t zsw_display_control_get_brightness(void);
+
+/*
+*   Request LVGL to render using small partial buffers or a buffer covering the full frame.
+*   Only the invalidated areas are rendered in both modes, but a full frame buffer lets LVGL
+*   render and flush a full screen redraw in one pass instead of one pass per partial buffer.
+*   The full frame buffer is allocated from the system heap, if not enough memory is free
+*   partial mode is kept. Applied before the next LVGL refresh.
+*
+*   Full frame is refused while there is memory pressure, see zsw_mem_pressure.h.
+*
+*   Return 0 on success, -ENOTSUP if CONFIG_ZSW_DISPLAY_FULL_FRAME_RENDER is not enabled,
+*   -ENOMEM if full frame was refused.
+*/
+int zsw_display_control_set_render_mode(zsw_display_render_mode_t mode);
+zsw_display_render_mode_t zsw_display_control_get_render_mode(void);
+
+/*
+*   Frame time and peak RAM (draw buffers + LVGL heap) measured while rendering in the given mode.
+*/
+void zsw_display_control_get_render_stats(zsw_display_render_mode_t mode, zsw_display_render_stats_t *stats);
 #endif
\ No newline at end of file
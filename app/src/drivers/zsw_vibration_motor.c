@@ -22,6 +22,8 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/logging/log.h>
 
+#include "managers/zsw_perf_profile.h"
+
 LOG_MODULE_REGISTER(zsw_vibration_motor, LOG_LEVEL_WRN);
 
 typedef struct vib_motor_state {
@@ -98,7 +100,7 @@ int zsw_vibration_run_pattern(zsw_vibration_pattern_t pattern)
 static void run_next_motor_state(vib_motor_state_t *state)
 {
     vibration_motor_set_on(state->enabled);
-    vibration_motor_set_power(state->percent);
+    vibration_motor_set_power(state->percent * zsw_perf_profile_get_policy()->max_vibration_percent / 100);
     k_timer_start(&vibration_timer, K_MSEC(state->delay), K_NO_WAIT);
 }
 
@@ -6,6 +6,10 @@ ZBUS_CHAN_DEFINE(accel_data_chan,
                  struct accel_event,
                  NULL,
                  NULL,
+#ifdef CONFIG_ZSW_SENSOR_HUB
+                 ZBUS_OBSERVERS(watchface_accel_lis, power_manager_accel_lis, zsw_sensor_hub_accel_lis),
+#else
                  ZBUS_OBSERVERS(watchface_accel_lis, power_manager_accel_lis),
+#endif
                  ZBUS_MSG_INIT()
                 );
\ No newline at end of file
@@ -5,6 +5,10 @@ ZBUS_CHAN_DEFINE(activity_state_data_chan,
                  struct activity_state_event,
                  NULL,
                  NULL,
+#ifdef CONFIG_ZSW_SENSOR_HUB
+                 ZBUS_OBSERVERS(watchface_activity_state_event, zsw_sensor_hub_activity_lis),
+#else
                  ZBUS_OBSERVERS(watchface_activity_state_event),
+#endif
                  ZBUS_MSG_INIT()
                 );
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "mem_pressure_event.h"
+#include <zephyr/zbus/zbus.h>
+
+ZBUS_CHAN_DEFINE(mem_pressure_data_chan,
+                 struct mem_pressure_event,
+                 NULL,
+                 NULL,
+                 ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT()
+                );
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "managers/zsw_mem_pressure.h"
+
+struct mem_pressure_event {
+    zsw_mem_pressure_level_t level;
+};
@@ -0,0 +1,10 @@
+#include "perf_profile_event.h"
+#include <zephyr/zbus/zbus.h>
+
+ZBUS_CHAN_DEFINE(perf_profile_data_chan,
+                 struct perf_profile_event,
+                 NULL,
+                 NULL,
+                 ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT()
+                );
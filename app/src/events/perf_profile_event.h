@@ -0,0 +1,7 @@
+#pragma once
+
+#include "managers/zsw_perf_profile.h"
+
+struct perf_profile_event {
+    zsw_perf_profile_t profile;
+};
@@ -5,6 +5,9 @@
 
 static struct k_work_delayable periodic_slow_work;
 static struct k_work_delayable periodic_fast_work;
+#ifdef CONFIG_ZSW_SENSOR_HUB
+static struct k_work_delayable periodic_batch_work;
+#endif
 
 ZBUS_CHAN_DEFINE(periodic_event_slow_chan,
                  struct periodic_event,
@@ -20,4 +23,14 @@ ZBUS_CHAN_DEFINE(periodic_event_fast_chan,
                  &periodic_fast_work,
                  ZBUS_OBSERVERS_EMPTY,
                  ZBUS_MSG_INIT()
-                );
\ No newline at end of file
+                );
+
+#ifdef CONFIG_ZSW_SENSOR_HUB
+ZBUS_CHAN_DEFINE(periodic_event_batch_chan,
+                 struct periodic_event,
+                 NULL,
+                 &periodic_batch_work,
+                 ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT()
+                );
+#endif
@@ -3,12 +3,21 @@
 #include <zephyr/zbus/zbus.h>
 
 #include "events/periodic_event.h"
+#include "managers/zsw_perf_profile.h"
 
 static void handle_slow_timeout(struct k_work *item);
 static void handle_fast_timeout(struct k_work *item);
+#ifdef CONFIG_ZSW_SENSOR_HUB
+static void handle_batch_timeout(struct k_work *item);
+#endif
 
 ZBUS_CHAN_DECLARE(periodic_event_slow_chan);
 ZBUS_CHAN_DECLARE(periodic_event_fast_chan);
+#ifdef CONFIG_ZSW_SENSOR_HUB
+ZBUS_CHAN_DECLARE(periodic_event_batch_chan);
+
+#define PERIODIC_BATCH_INTERVAL_MS  (CONFIG_ZSW_SENSOR_HUB_BATCH_INTERVAL_S * 1000)
+#endif
 
 int zsw_periodic_chan_add_obs(const struct zbus_channel *chan, const struct zbus_observer *obs)
 {
@@ -28,7 +37,11 @@ int zsw_periodic_chan_add_obs(const struct zbus_channel *chan, const struct zbus
         if (chan == &periodic_event_slow_chan) {
             ret =  k_work_reschedule(work, K_MSEC(1000));
         } else if (chan == &periodic_event_fast_chan) {
-            ret =  k_work_reschedule(work, K_MSEC(100));
+            ret =  k_work_reschedule(work, K_MSEC(zsw_perf_profile_get_policy()->periodic_fast_interval_ms));
+#ifdef CONFIG_ZSW_SENSOR_HUB
+        } else if (chan == &periodic_event_batch_chan) {
+            ret =  k_work_reschedule(work, K_MSEC(PERIODIC_BATCH_INTERVAL_MS));
+#endif
         } else {
             __ASSERT(false, "Unknown channel");
         }
@@ -70,12 +83,27 @@ static void handle_fast_timeout(struct k_work *item)
     struct k_work_delayable *work = NULL;
     zbus_chan_claim(&periodic_event_fast_chan, K_FOREVER);
     work = (struct k_work_delayable *)zbus_chan_user_data(&periodic_event_fast_chan);
-    k_work_reschedule(work, K_MSEC(100));
+    k_work_reschedule(work, K_MSEC(zsw_perf_profile_get_policy()->periodic_fast_interval_ms));
     zbus_chan_finish(&periodic_event_fast_chan);
 
     zbus_chan_pub(&periodic_event_fast_chan, &evt, K_MSEC(250));
 }
 
+#ifdef CONFIG_ZSW_SENSOR_HUB
+static void handle_batch_timeout(struct k_work *item)
+{
+    struct periodic_event evt = {
+    };
+    struct k_work_delayable *work = NULL;
+    zbus_chan_claim(&periodic_event_batch_chan, K_FOREVER);
+    work = (struct k_work_delayable *)zbus_chan_user_data(&periodic_event_batch_chan);
+    k_work_reschedule(work, K_MSEC(PERIODIC_BATCH_INTERVAL_MS));
+    zbus_chan_finish(&periodic_event_batch_chan);
+
+    zbus_chan_pub(&periodic_event_batch_chan, &evt, K_MSEC(250));
+}
+#endif
+
 static int zsw_timer_init(void)
 {
     struct k_work_delayable *work = NULL;
@@ -88,6 +116,13 @@ static int zsw_timer_init(void)
     work = (struct k_work_delayable *)zbus_chan_user_data(&periodic_event_fast_chan);
     k_work_init_delayable(work, handle_fast_timeout);
     zbus_chan_finish(&periodic_event_fast_chan);
+
+#ifdef CONFIG_ZSW_SENSOR_HUB
+    zbus_chan_claim(&periodic_event_batch_chan, K_FOREVER);
+    work = (struct k_work_delayable *)zbus_chan_user_data(&periodic_event_batch_chan);
+    k_work_init_delayable(work, handle_batch_timeout);
+    zbus_chan_finish(&periodic_event_batch_chan);
+#endif
     return 0;
 }
 
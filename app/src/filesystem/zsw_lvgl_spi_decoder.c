@@ -23,6 +23,8 @@
 #include <lvgl.h>
 #include "lv_conf.h"
 #include LV_MEM_CUSTOM_INCLUDE
+#include <filesystem/zsw_lvgl_spi_decoder.h>
+#include <filesystem/zsw_storage_probe.h>
 
 #define TABLE_HEADER_MAGIC 0x0A0A0A0A
 
@@ -53,17 +55,57 @@ typedef struct file_table_t {
 } file_table_t;
 
 typedef struct opened_file_t {
-    file_header_t  *header;
+    // Copy of the header and absolute data offset so an opened file does
+    // not depend on the file table once it is opened.
+    file_header_t   header;
+    uint32_t        data_offset;
     uint32_t        index;
+    bool            in_use;
 } opened_file_t;
 
 static file_table_t file_table;
+static bool file_table_loaded;
+static bool file_table_sorted;
 static opened_file_t opened_files[MAX_OPENED_FILES];
 
 static const struct flash_area *flash_area;
 
+K_MUTEX_DEFINE(decoder_mutex);
+
+static bool is_table_sorted(file_table_t *table)
+{
+    if (table->num_files > ARRAY_SIZE(table->file_headers)) {
+        return false;
+    }
+    for (int i = 1; i < table->num_files; i++) {
+        if (strncmp(table->file_headers[i - 1].filename, table->file_headers[i].filename, MAX_FILE_NAME_LEN) >= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 static file_header_t *find_file(const char *name)
 {
+    // Images from create_custom_resource_image.py are sorted by name,
+    // older unsorted images are searched linearly.
+    if (file_table_sorted) {
+        int low = 0;
+        int high = file_table.num_files - 1;
+        while (low <= high) {
+            int mid = (low + high) / 2;
+            int cmp = strncmp(name, file_table.file_headers[mid].filename, MAX_FILE_NAME_LEN);
+            if (cmp == 0) {
+                return &file_table.file_headers[mid];
+            } else if (cmp < 0) {
+                high = mid - 1;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return NULL;
+    }
+
     for (int i = 0; i < file_table.num_files; i++) {
         if (strncmp(name, file_table.file_headers[i].filename, MAX_FILE_NAME_LEN) == 0) {
             return &file_table.file_headers[i];
@@ -75,7 +117,7 @@ static file_header_t *find_file(const char *name)
 static opened_file_t *find_free_opened_file(void)
 {
     for (int i = 0; i < MAX_OPENED_FILES; i++) {
-        if (opened_files[i].header == NULL) {
+        if (!opened_files[i].in_use) {
             return &opened_files[i];
         }
     }
@@ -127,34 +169,43 @@ static lv_fs_res_t errno_to_lv_fs_res(int err)
 static void *lvgl_fs_open(struct _lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode)
 {
     file_header_t *file;
+    opened_file_t *open_file = NULL;
+
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
 
     if (file_table.magic != TABLE_HEADER_MAGIC) {
-        return NULL;
+        goto out;
     }
 
     file = find_file(path);
-    opened_file_t *open_file;
-
     if (!file) {
-        return NULL;
+        goto out;
     }
 
     open_file = find_free_opened_file();
-    if (!file) {
-        return NULL;
+    if (!open_file) {
+        goto out;
     }
 
-    open_file->header = file;
+    open_file->header = *file;
+    open_file->data_offset = file_table.header_length + file->offset;
     open_file->index = 0;
+    open_file->in_use = true;
 
+out:
+    k_mutex_unlock(&decoder_mutex);
     return open_file;
 }
 
 static lv_fs_res_t lvgl_fs_close(struct _lv_fs_drv_t *drv, void *file)
 {
     opened_file_t *open_file = (opened_file_t *)file;
-    open_file->header = NULL;
+
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    open_file->in_use = false;
     open_file->index = 0;
+    k_mutex_unlock(&decoder_mutex);
+
     return errno_to_lv_fs_res(0);
 }
 
@@ -163,8 +214,10 @@ static lv_fs_res_t lvgl_fs_read(struct _lv_fs_drv_t *drv, void *file, void *buf,
 {
     int rc;
     opened_file_t *open_file = (opened_file_t *)file;
+    uint32_t start = zsw_storage_probe_begin();
 
-    rc = flash_area_read(flash_area, open_file->header->offset + open_file->index + file_table.header_length, buf, btr);
+    rc = flash_area_read(flash_area, open_file->data_offset + open_file->index, buf, btr);
+    zsw_storage_probe_end("S: read", start);
     if (rc != 0) {
         printk("Flash read failed! %d\n", rc);
         *br = 0;
@@ -187,7 +240,7 @@ static lv_fs_res_t lvgl_fs_seek(struct _lv_fs_drv_t *drv, void *file, uint32_t p
 
     switch (whence) {
         case LV_FS_SEEK_END:
-            open_file->index = open_file->header->len;
+            open_file->index = open_file->header.len;
             break;
         case LV_FS_SEEK_CUR:
             // We are already there?
@@ -227,6 +280,76 @@ static lv_fs_res_t lvgl_fs_dir_close(struct _lv_fs_drv_t *drv, void *dir)
 
 static lv_fs_drv_t fs_drv;
 
+// Must be called with decoder_mutex held.
+static int load_file_table(void)
+{
+    int rc;
+
+    if (file_table_loaded) {
+        return 0;
+    }
+
+    if (!flash_area) {
+        rc = flash_area_open(FLASH_PARTITION_ID, &flash_area);
+        if (rc != 0) {
+            printk("FAIL: unable to find flash area %u: %d\n", FLASH_PARTITION_ID, rc);
+            flash_area = NULL;
+            return -ENODEV;
+        }
+    }
+
+    rc = flash_area_read(flash_area, 0, &file_table, FILE_TABLE_MAX_LEN);
+    if (rc != 0) {
+        printk("Flash read failed! %d\n", rc);
+        return rc;
+    }
+    file_table_sorted = is_table_sorted(&file_table);
+    file_table_loaded = true;
+
+    return 0;
+}
+
+int zsw_decoder_get_file_location(const char *name, uint32_t *offset, uint32_t *len)
+{
+    int rc;
+    file_header_t *file;
+
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+
+    rc = load_file_table();
+    if (rc != 0) {
+        goto out;
+    }
+
+    if (file_table.magic != TABLE_HEADER_MAGIC) {
+        rc = -EBADF;
+        goto out;
+    }
+
+    file = find_file(name);
+    if (!file) {
+        rc = -ENOENT;
+        goto out;
+    }
+
+    *offset = file_table.header_length + file->offset;
+    *len = file->len;
+
+out:
+    k_mutex_unlock(&decoder_mutex);
+
+    return rc;
+}
+
+int zsw_decoder_read_raw(uint32_t offset, void *buf, size_t len)
+{
+    if (!flash_area) {
+        return -ENODEV;
+    }
+
+    return flash_area_read(flash_area, offset, buf, len);
+}
+
 int zsw_decoder_init(void)
 {
     int rc;
@@ -256,19 +379,12 @@ int zsw_decoder_init(void)
 
     memset(opened_files, 0, sizeof(opened_files));
 
-    rc = flash_area_open(FLASH_PARTITION_ID, &flash_area);
+    k_mutex_lock(&decoder_mutex, K_FOREVER);
+    rc = load_file_table();
+    k_mutex_unlock(&decoder_mutex);
 
-    if (rc != 0) {
-        printk("FAIL: unable to find flash area %u: %d\n", FLASH_PARTITION_ID, rc);
-        return 0;
-    }
-
-    rc = flash_area_read(flash_area, 0, &file_table, FILE_TABLE_MAX_LEN);
-    if (rc != 0) {
-        printk("Flash read failed! %d\n", rc);
-        return rc;
-    }
-    return 0;
+    // A missing flash area is not fatal, "S:" then just has no files.
+    return rc == -ENODEV ? 0 : rc;
 }
 
 SYS_INIT(zsw_decoder_init, APPLICATION, 99);
@@ -0,0 +1,35 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+* Absolute offset in lvgl_raw_partition and length of a file in the active
+* resource image. Loads the file table on first use, so it may be called
+* before the "S:" drive is registered, e.g. during early boot.
+* Returns -ENODEV if there is no resource partition, -EBADF if it holds no
+* valid image and -ENOENT if the file is not in it.
+*/
+int zsw_decoder_get_file_location(const char *name, uint32_t *offset, uint32_t *len);
+
+/*
+* Read len bytes at an absolute offset in lvgl_raw_partition.
+*/
+int zsw_decoder_read_raw(uint32_t offset, void *buf, size_t len);
@@ -0,0 +1,118 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
+#include "filesystem/zsw_storage_probe.h"
+
+LOG_MODULE_REGISTER(zsw_storage_probe, LOG_LEVEL_INF);
+
+#define MAX_CALL_SITES 16
+
+typedef struct call_site {
+    const char *what;
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t ui_count;
+    uint32_t ui_max_us;
+    uint32_t ui_flagged;
+} call_site_t;
+
+static void report_work_handler(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(report_work, report_work_handler);
+
+static call_site_t call_sites[MAX_CALL_SITES];
+static struct k_spinlock lock;
+
+static call_site_t *find_call_site(const char *what)
+{
+    for (int i = 0; i < MAX_CALL_SITES; i++) {
+        if (!call_sites[i].what) {
+            call_sites[i].what = what;
+            return &call_sites[i];
+        }
+        if (call_sites[i].what == what || strcmp(call_sites[i].what, what) == 0) {
+            return &call_sites[i];
+        }
+    }
+
+    return NULL;
+}
+
+uint32_t zsw_storage_probe_begin(void)
+{
+    return k_cycle_get_32();
+}
+
+void zsw_storage_probe_end(const char *what, uint32_t start)
+{
+    uint32_t duration_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    // LVGL draws and reads input from the system workqueue, see zsw_display_control.c.
+    bool is_ui = k_current_get() == k_work_queue_thread_get(&k_sys_work_q);
+    bool flag = is_ui && duration_us > CONFIG_ZSW_STORAGE_PROBE_UI_THRESHOLD_MS * USEC_PER_MSEC;
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    call_site_t *site = find_call_site(what);
+
+    if (site) {
+        site->count++;
+        site->max_us = MAX(site->max_us, duration_us);
+        if (is_ui) {
+            site->ui_count++;
+            site->ui_max_us = MAX(site->ui_max_us, duration_us);
+            site->ui_flagged += flag ? 1 : 0;
+        }
+    }
+    k_spin_unlock(&lock, key);
+
+    if (flag) {
+        LOG_WRN("%s blocked the UI for %d ms", what, duration_us / USEC_PER_MSEC);
+    }
+}
+
+void zsw_storage_probe_report(void)
+{
+    call_site_t sites[MAX_CALL_SITES];
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    memcpy(sites, call_sites, sizeof(sites));
+    k_spin_unlock(&lock, key);
+
+    for (int i = 0; i < MAX_CALL_SITES && sites[i].what; i++) {
+        LOG_INF("%s: %d calls max %d us, UI: %d calls max %d us, %d over %d ms", sites[i].what, sites[i].count,
+                sites[i].max_us, sites[i].ui_count, sites[i].ui_max_us, sites[i].ui_flagged,
+                CONFIG_ZSW_STORAGE_PROBE_UI_THRESHOLD_MS);
+    }
+}
+
+static void report_work_handler(struct k_work *work)
+{
+    zsw_storage_probe_report();
+    k_work_schedule(&report_work, K_SECONDS(CONFIG_ZSW_STORAGE_PROBE_REPORT_INTERVAL_S));
+}
+
+static int zsw_storage_probe_init(void)
+{
+    k_work_schedule(&report_work, K_SECONDS(CONFIG_ZSW_STORAGE_PROBE_REPORT_INTERVAL_S));
+
+    return 0;
+}
+
+SYS_INIT(zsw_storage_probe_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
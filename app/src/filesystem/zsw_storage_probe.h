@@ -0,0 +1,48 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef CONFIG_ZSW_STORAGE_PROBE
+/*
+*   Call before a storage operation, pass the returned value to
+*   zsw_storage_probe_end together with a name for the call site.
+*/
+uint32_t zsw_storage_probe_begin(void);
+
+/*
+*   Record the time since zsw_storage_probe_begin for the call site 'what'.
+*   'what' must be a string that stays valid, a literal or a settings key.
+*/
+void zsw_storage_probe_end(const char *what, uint32_t start);
+
+/*
+*   Log max duration and count per call site, split in UI and other threads.
+*/
+void zsw_storage_probe_report(void);
+#else
+static inline uint32_t zsw_storage_probe_begin(void)
+{
+    return 0;
+}
+
+static inline void zsw_storage_probe_end(const char *what, uint32_t start) {}
+
+static inline void zsw_storage_probe_report(void) {}
+#endif
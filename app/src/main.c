@@ -53,7 +53,9 @@
 #include "managers/zsw_power_manager.h"
 #include "managers/zsw_app_manager.h"
 #include "managers/zsw_notification_manager.h"
+#include "managers/zsw_mem_pressure.h"
 #include "applications/watchface/watchface_app.h"
+#include "ui/utils/zsw_ui_transition.h"
 #include <filesystem/zsw_rtt_flash_loader.h>
 #include "ble/ble_ams.h"
 #include "ble/ble_ancs.h"
@@ -313,7 +315,9 @@ static void enable_bluetoth(void)
     err = bt_enable(NULL);
 
 #ifdef CONFIG_SETTINGS
+    uint32_t settings_start_ms = k_uptime_get_32();
     settings_load();
+    LOG_INF("Settings loaded in %d ms", k_uptime_get_32() - settings_start_ms);
 #endif
     if (err != 0) {
         LOG_ERR("Failed to enable Bluetooth, err: %d", err);
@@ -325,7 +329,7 @@ static void enable_bluetoth(void)
 
     ble_ams_init();
     ble_cts_init();
-    ble_ancs_init(on_ble_data_callback);
+    ble_ancs_init();
 }
 
 static void print_retention_ram(void)
@@ -344,12 +348,14 @@ static void open_notification_popup(void *data)
         zsw_vibration_run_pattern(ZSW_VIBRATION_PATTERN_NOTIFICATION);
         zsw_notification_popup_show(not->title, not->body, not->src, not->id, on_popup_notifcation_closed, 10);
         is_buttons_for_lvgl = true;
+        zsw_mem_pressure_check();
     }
     pending_not_open = false;
 }
 
 static void open_application_manager_page(void *app_name)
 {
+    zsw_ui_transition_capture(ZSW_UI_TRANSITION_SLIDE_LEFT);
     watchface_app_stop();
     is_buttons_for_lvgl = true;
     watch_state = APPLICATION_MANAGER_STATE;
@@ -597,6 +603,7 @@ static void on_zbus_ble_data_callback(const struct zbus_channel *chan)
             if (event->data.data.remote_control.button == 4) {
                 zsw_power_manager_reset_idle_timout();
                 if (watch_state == APPLICATION_MANAGER_STATE) {
+                    zsw_ui_transition_capture(ZSW_UI_TRANSITION_SLIDE_RIGHT);
                     zsw_app_manager_delete();
                     zsw_app_manager_set_index(0);
                     is_buttons_for_lvgl = false;
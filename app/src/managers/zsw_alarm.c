@@ -0,0 +1,176 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/counter.h>
+#include <zephyr/logging/log.h>
+
+#include "managers/zsw_alarm.h"
+
+LOG_MODULE_REGISTER(zsw_alarm, LOG_LEVEL_INF);
+
+#define ALARM_CHANNEL   0
+
+static void handle_alarm_work(struct k_work *item);
+
+static const struct device *const counter = DEVICE_DT_GET_OR_NULL(DT_ALIAS(zsw_alarm_counter));
+
+K_WORK_DEFINE(alarm_work, handle_alarm_work);
+
+// Sorted on due_ms, first to expire first.
+static sys_slist_t alarms = SYS_SLIST_STATIC_INIT(&alarms);
+static struct k_spinlock lock;
+static zsw_alarm_stats_t stats;
+
+static void counter_alarm_cb(const struct device *dev, uint8_t chan_id, uint32_t ticks, void *user_data)
+{
+    stats.num_wakeups++;
+    k_work_submit(&alarm_work);
+}
+
+// Must be called with lock held.
+static void arm_counter(int64_t now)
+{
+    zsw_alarm_t *first = SYS_SLIST_PEEK_HEAD_CONTAINER(&alarms, first, node);
+    struct counter_alarm_cfg cfg = {
+        .callback = counter_alarm_cb,
+        .flags = 0,
+    };
+    uint64_t delay_us;
+
+    counter_cancel_channel_alarm(counter, ALARM_CHANNEL);
+    if (!first) {
+        return;
+    }
+
+    delay_us = first->due_ms > now ? (first->due_ms - now) * USEC_PER_MSEC : 0;
+    // Alarms further away than the counter can wrap, the work then only re-arms.
+    cfg.ticks = MIN(counter_us_to_ticks(counter, delay_us), counter_get_top_value(counter));
+    cfg.ticks = MAX(cfg.ticks, 1);
+    counter_set_channel_alarm(counter, ALARM_CHANNEL, &cfg);
+}
+
+static void insert_sorted(zsw_alarm_t *alarm)
+{
+    zsw_alarm_t *prev = NULL;
+    zsw_alarm_t *it;
+
+    SYS_SLIST_FOR_EACH_CONTAINER(&alarms, it, node) {
+        if (it->due_ms > alarm->due_ms) {
+            break;
+        }
+        prev = it;
+    }
+
+    if (prev) {
+        sys_slist_insert(&alarms, &prev->node, &alarm->node);
+    } else {
+        sys_slist_prepend(&alarms, &alarm->node);
+    }
+}
+
+static zsw_alarm_t *pop_expired(int64_t now)
+{
+    zsw_alarm_t *first;
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    first = SYS_SLIST_PEEK_HEAD_CONTAINER(&alarms, first, node);
+    if (first && first->due_ms <= now + CONFIG_ZSW_ALARM_SLACK_MS) {
+        sys_slist_remove(&alarms, NULL, &first->node);
+        first->pending = false;
+    } else {
+        first = NULL;
+    }
+    k_spin_unlock(&lock, key);
+
+    return first;
+}
+
+static void handle_alarm_work(struct k_work *item)
+{
+    int64_t now = k_uptime_get();
+    zsw_alarm_t *alarm;
+    k_spinlock_key_t key;
+
+    // Pop one at a time as the callback may start the same alarm again.
+    while ((alarm = pop_expired(now))) {
+        stats.num_fired++;
+        alarm->cb(alarm);
+    }
+
+    key = k_spin_lock(&lock);
+    arm_counter(k_uptime_get());
+    k_spin_unlock(&lock, key);
+}
+
+int zsw_alarm_start(zsw_alarm_t *alarm, uint32_t timeout_ms)
+{
+    k_spinlock_key_t key;
+    int64_t now;
+
+    if (!device_is_ready(counter)) {
+        return -ENODEV;
+    }
+
+    __ASSERT(alarm->cb, "Alarm without callback");
+
+    key = k_spin_lock(&lock);
+    if (alarm->pending) {
+        sys_slist_find_and_remove(&alarms, &alarm->node);
+    }
+    now = k_uptime_get();
+    alarm->due_ms = now + timeout_ms;
+    alarm->pending = true;
+    insert_sorted(alarm);
+    arm_counter(now);
+    k_spin_unlock(&lock, key);
+
+    return 0;
+}
+
+void zsw_alarm_cancel(zsw_alarm_t *alarm)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (alarm->pending) {
+        sys_slist_find_and_remove(&alarms, &alarm->node);
+        alarm->pending = false;
+        if (device_is_ready(counter)) {
+            arm_counter(k_uptime_get());
+        }
+    }
+    k_spin_unlock(&lock, key);
+}
+
+void zsw_alarm_get_stats(zsw_alarm_stats_t *out)
+{
+    *out = stats;
+}
+
+static int zsw_alarm_init(void)
+{
+    if (!device_is_ready(counter)) {
+        LOG_WRN("No alarm counter");
+        return -ENODEV;
+    }
+
+    return counter_start(counter);
+}
+
+SYS_INIT(zsw_alarm_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
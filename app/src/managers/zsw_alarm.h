@@ -0,0 +1,58 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_ALARM_H_
+#define __ZSW_ALARM_H_
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/slist.h>
+
+struct zsw_alarm_t;
+
+typedef void (*zsw_alarm_cb_t)(struct zsw_alarm_t *alarm);
+
+/*
+*   One shot alarm backed by the low power RTC counter (zsw-alarm-counter
+*   DT alias), so nothing runs while the alarm is pending. The callback
+*   runs on the system workqueue and may start the alarm again.
+*/
+typedef struct zsw_alarm_t {
+    zsw_alarm_cb_t cb;
+    void *user_data;
+    // Internal.
+    sys_snode_t node;
+    int64_t due_ms;
+    bool pending;
+} zsw_alarm_t;
+
+typedef struct zsw_alarm_stats_t {
+    uint32_t num_wakeups; // Times the counter fired, including wakeups to re-arm very long alarms.
+    uint32_t num_fired; // Alarm callbacks run.
+} zsw_alarm_stats_t;
+
+/*
+*   Start or restart an alarm timeout_ms from now. Alarms within
+*   CONFIG_ZSW_ALARM_SLACK_MS of each other fire on the same wakeup.
+*   Returns 0 or -ENODEV if there is no alarm counter.
+*/
+int zsw_alarm_start(zsw_alarm_t *alarm, uint32_t timeout_ms);
+
+void zsw_alarm_cancel(zsw_alarm_t *alarm);
+
+void zsw_alarm_get_stats(zsw_alarm_stats_t *stats);
+
+#endif // __ZSW_ALARM_H_
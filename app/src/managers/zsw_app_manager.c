@@ -20,6 +20,10 @@
 #include <zephyr/logging/log.h>
 
 #include "managers/zsw_app_manager.h"
+#include "drivers/zsw_display_control.h"
+#include "ui/utils/zsw_ui_transition.h"
+#include "ui/utils/zsw_ui_mem.h"
+#include "managers/zsw_mem_pressure.h"
 
 LOG_MODULE_REGISTER(APP_MANAGER, LOG_LEVEL_INF);
 
@@ -100,21 +104,31 @@ static void async_app_start(lv_timer_t *timer)
 {
     async_app_start_timer = NULL;
     LOG_DBG("Start %d", current_app);
+    zsw_ui_transition_capture(ZSW_UI_TRANSITION_SLIDE_LEFT);
     delete_application_picker();
+    if (apps[current_app]->full_frame_render) {
+        zsw_display_control_set_render_mode(ZSW_DISPLAY_RENDER_MODE_FULL_FRAME);
+    }
     apps[current_app]->start_func(root_obj, group_obj);
+    zsw_ui_transition_start();
+    zsw_mem_pressure_check();
 }
 
 static void async_app_close(lv_timer_t *timer)
 {
+    zsw_ui_transition_capture(ZSW_UI_TRANSITION_SLIDE_RIGHT);
     if (current_app < num_apps) {
         LOG_DBG("Stop %d", current_app);
         apps[current_app]->stop_func();
+        zsw_ui_mem_release_and_sample();
+        zsw_display_control_set_render_mode(ZSW_DISPLAY_RENDER_MODE_PARTIAL);
         current_app = INVALID_APP_ID;
         if (app_launch_only) {
             zsw_app_manager_delete();
             close_cb_func();
         } else {
             draw_application_picker();
+            zsw_ui_transition_start();
         }
     } else {
         // No app running, then close whole application_manager
@@ -271,10 +285,12 @@ int zsw_app_manager_show(on_app_manager_cb_fn close_cb, lv_obj_t *root, lv_group
 
     if (app_name == NULL) {
         draw_application_picker();
+        zsw_ui_transition_start();
     } else {
         app_found = false;
         for (int i = 0; i < num_apps; i++) {
             if (strcmp(apps[i]->name, app_name) == 0) {
+                app_found = true;
                 app_launch_only = true;
                 current_app = i;
                 if (!apps[i]->hidden) {
@@ -289,6 +305,7 @@ int zsw_app_manager_show(on_app_manager_cb_fn close_cb, lv_obj_t *root, lv_group
     }
 
     if (app_name != NULL && !app_found) {
+        zsw_ui_transition_cancel();
         err = -ENOENT;
     }
 
@@ -300,6 +317,8 @@ void zsw_app_manager_delete(void)
     if (current_app < num_apps) {
         LOG_DBG("Stop force %d", current_app);
         apps[current_app]->stop_func();
+        zsw_ui_mem_release_and_sample();
+        zsw_display_control_set_render_mode(ZSW_DISPLAY_RENDER_MODE_PARTIAL);
     }
     delete_application_picker();
 }
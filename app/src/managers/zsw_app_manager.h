@@ -30,6 +30,7 @@ typedef struct application_t {
     char                   *name;
     const lv_img_dsc_t     *icon;
     bool                    hidden;
+    bool                    full_frame_render;
     uint8_t                 private_list_index;
 } application_t;
 
@@ -0,0 +1,210 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/logging/log.h>
+
+#include "events/activity_event.h"
+#include "events/chg_event.h"
+#include "managers/zsw_maintenance.h"
+
+LOG_MODULE_REGISTER(zsw_maintenance, LOG_LEVEL_INF);
+
+#define MAX_TASKS 8
+
+static void zbus_chg_state_callback(const struct zbus_channel *chan);
+static void zbus_activity_event_callback(const struct zbus_channel *chan);
+static void handle_maintenance_work(struct k_work *item);
+
+ZBUS_CHAN_DECLARE(chg_state_data_chan);
+ZBUS_CHAN_DECLARE(activity_state_data_chan);
+ZBUS_LISTENER_DEFINE(zsw_maintenance_chg_lis, zbus_chg_state_callback);
+ZBUS_LISTENER_DEFINE(zsw_maintenance_activity_lis, zbus_activity_event_callback);
+
+K_WORK_DELAYABLE_DEFINE(maintenance_work, handle_maintenance_work);
+K_MUTEX_DEFINE(tasks_lock);
+
+static zsw_maintenance_task_t *tasks[MAX_TASKS];
+static int num_tasks;
+static bool is_charging;
+static bool is_idle;
+static bool window_open;
+static uint32_t window_opened_s;
+
+static uint32_t uptime_s(void)
+{
+    return k_uptime_get() / MSEC_PER_SEC;
+}
+
+static bool is_overdue(zsw_maintenance_task_t *task, uint32_t now)
+{
+    return now - task->pending_since_s >= task->deadline_s;
+}
+
+static bool is_window_settled(uint32_t now)
+{
+    return window_open && now - window_opened_s >= CONFIG_ZSW_MAINTENANCE_SETTLE_SECONDS;
+}
+
+static void schedule_next(void)
+{
+    uint32_t now = uptime_s();
+    uint32_t delay_s = UINT32_MAX;
+
+    k_mutex_lock(&tasks_lock, K_FOREVER);
+    for (int i = 0; i < num_tasks; i++) {
+        if (!tasks[i]->pending) {
+            continue;
+        }
+        if (is_window_settled(now) || is_overdue(tasks[i], now)) {
+            delay_s = 0;
+            break;
+        }
+        if (window_open) {
+            delay_s = MIN(delay_s, window_opened_s + CONFIG_ZSW_MAINTENANCE_SETTLE_SECONDS - now);
+        }
+        delay_s = MIN(delay_s, tasks[i]->pending_since_s + tasks[i]->deadline_s - now);
+    }
+    k_mutex_unlock(&tasks_lock);
+
+    if (delay_s == UINT32_MAX) {
+        k_work_cancel_delayable(&maintenance_work);
+    } else {
+        k_work_reschedule(&maintenance_work, K_SECONDS(delay_s));
+    }
+}
+
+static void run_task(zsw_maintenance_task_t *task, uint32_t now)
+{
+    int64_t start = k_uptime_get();
+
+    task->run();
+
+    task->last_duration_ms = k_uptime_get() - start;
+    task->max_duration_ms = MAX(task->max_duration_ms, task->last_duration_ms);
+    task->last_run_s = uptime_s();
+    LOG_INF("%s took %d ms (max %d ms), waited %d s%s", task->name, task->last_duration_ms, task->max_duration_ms,
+            now - task->pending_since_s, is_overdue(task, now) ? ", deadline hit" : "");
+}
+
+static void handle_maintenance_work(struct k_work *item)
+{
+    zsw_maintenance_task_t *task;
+    uint32_t now;
+
+    // One task at a time, so that the batch stops as soon as the window closes.
+    while (true) {
+        task = NULL;
+        now = uptime_s();
+        k_mutex_lock(&tasks_lock, K_FOREVER);
+        for (int i = 0; i < num_tasks; i++) {
+            if (tasks[i]->pending && (is_window_settled(now) || is_overdue(tasks[i], now))) {
+                task = tasks[i];
+                task->pending = false;
+                break;
+            }
+        }
+        k_mutex_unlock(&tasks_lock);
+
+        if (!task) {
+            break;
+        }
+        run_task(task, now);
+    }
+
+    schedule_next();
+}
+
+int zsw_maintenance_register(zsw_maintenance_task_t *task)
+{
+    int ret = 0;
+
+    __ASSERT(task->run, "Task %s has no run function", task->name);
+
+    k_mutex_lock(&tasks_lock, K_FOREVER);
+    if (num_tasks < MAX_TASKS) {
+        tasks[num_tasks++] = task;
+    } else {
+        LOG_ERR("No free slot for %s", task->name);
+        ret = -ENOMEM;
+    }
+    k_mutex_unlock(&tasks_lock);
+
+    return ret;
+}
+
+void zsw_maintenance_request(zsw_maintenance_task_t *task)
+{
+    uint32_t now = uptime_s();
+    bool added = false;
+
+    k_mutex_lock(&tasks_lock, K_FOREVER);
+    if (!task->pending && (task->last_run_s == 0 || now - task->last_run_s >= task->min_interval_s)) {
+        task->pending = true;
+        task->pending_since_s = now;
+        added = true;
+    }
+    k_mutex_unlock(&tasks_lock);
+
+    if (added) {
+        schedule_next();
+    }
+}
+
+static void update_window(void)
+{
+    bool open = is_charging && is_idle;
+
+    if (open == window_open) {
+        return;
+    }
+
+    window_open = open;
+    if (open) {
+        window_opened_s = uptime_s();
+    }
+    LOG_DBG("Maintenance window %s", open ? "open" : "closed");
+    schedule_next();
+}
+
+static void zbus_chg_state_callback(const struct zbus_channel *chan)
+{
+    const struct chg_state_event *event = zbus_chan_const_msg(chan);
+
+    is_charging = event->is_charging;
+    update_window();
+}
+
+static void zbus_activity_event_callback(const struct zbus_channel *chan)
+{
+    const struct activity_state_event *event = zbus_chan_const_msg(chan);
+
+    is_idle = event->state != ZSW_ACTIVITY_STATE_ACTIVE;
+    update_window();
+}
+
+static int zsw_maintenance_init(void)
+{
+    zbus_chan_add_obs(&chg_state_data_chan, &zsw_maintenance_chg_lis, K_MSEC(100));
+    zbus_chan_add_obs(&activity_state_data_chan, &zsw_maintenance_activity_lis, K_MSEC(100));
+
+    return 0;
+}
+
+SYS_INIT(zsw_maintenance_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
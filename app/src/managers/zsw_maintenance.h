@@ -0,0 +1,53 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_MAINTENANCE_H_
+#define __ZSW_MAINTENANCE_H_
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+*   Deferrable housekeeping. A requested task runs in a batch when the watch
+*   is on the charger and not in use, or at the latest deadline_s seconds
+*   after it was first requested.
+*/
+typedef struct zsw_maintenance_task_t {
+    const char *name;
+    void (*run)(void); // Called from the system workqueue.
+    uint32_t min_interval_s; // Requests within this time from the last run are ignored.
+    uint32_t deadline_s; // Max time a request may wait for the charger window.
+    // Internal, zero initialize.
+    bool pending;
+    uint32_t pending_since_s;
+    uint32_t last_run_s;
+    uint32_t last_duration_ms;
+    uint32_t max_duration_ms;
+} zsw_maintenance_task_t;
+
+/*
+*   Register a task. The task struct must stay valid forever.
+*   Returns 0 or -ENOMEM if all slots are taken.
+*/
+int zsw_maintenance_register(zsw_maintenance_task_t *task);
+
+/*
+*   Mark a task as needing to run. Calling it again while pending does
+*   not move the deadline.
+*/
+void zsw_maintenance_request(zsw_maintenance_task_t *task);
+
+#endif // __ZSW_MAINTENANCE_H_
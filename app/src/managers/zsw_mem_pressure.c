@@ -0,0 +1,197 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include "events/mem_pressure_event.h"
+#include "managers/zsw_mem_pressure.h"
+
+LOG_MODULE_REGISTER(zsw_mem_pressure, LOG_LEVEL_INF);
+
+// While under pressure, measure again this often to notice when it's gone.
+#define RECHECK_INTERVAL_S  5
+
+#if CONFIG_HEAP_MEM_POOL_SIZE > 0 && defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+#define HAS_HEAP_STATS
+extern struct k_heap _system_heap;
+#endif
+
+static void handle_check_work(struct k_work *item);
+
+ZBUS_CHAN_DECLARE(mem_pressure_data_chan);
+
+K_WORK_DELAYABLE_DEFINE(check_work, handle_check_work);
+K_MUTEX_DEFINE(handlers_lock);
+
+static const char *level_names[ZSW_MEM_PRESSURE_NUM] = {"none", "moderate", "critical"};
+
+static zsw_mem_pressure_handler_t *handlers[CONFIG_ZSW_MEM_PRESSURE_MAX_HANDLERS];
+static int num_handlers;
+static zsw_mem_pressure_stats_t stats = {
+    .min_lvgl_free_percent = 100,
+    .min_heap_free_percent = 100,
+};
+
+static uint8_t lvgl_free_percent(void)
+{
+    lv_mem_monitor_t mon;
+
+    lv_mem_monitor(&mon);
+    if (mon.total_size == 0) {
+        return 100;
+    }
+    // Use the largest free block, a fragmented pool fails large allocations
+    // long before it is full.
+    return (uint64_t)mon.free_biggest_size * 100 / mon.total_size;
+}
+
+static uint8_t heap_free_percent(void)
+{
+#ifdef HAS_HEAP_STATS
+    struct sys_memory_stats heap_stats;
+    size_t total;
+
+    if (sys_heap_runtime_stats_get(&_system_heap.heap, &heap_stats) != 0) {
+        return 100;
+    }
+    total = heap_stats.free_bytes + heap_stats.allocated_bytes;
+    if (total == 0) {
+        return 100;
+    }
+    return (uint64_t)heap_stats.free_bytes * 100 / total;
+#else
+    return 100;
+#endif
+}
+
+static zsw_mem_pressure_level_t measure(void)
+{
+    uint8_t lvgl_percent = lvgl_free_percent();
+    uint8_t heap_percent = heap_free_percent();
+    uint8_t free_percent = MIN(lvgl_percent, heap_percent);
+
+    stats.min_lvgl_free_percent = MIN(stats.min_lvgl_free_percent, lvgl_percent);
+    stats.min_heap_free_percent = MIN(stats.min_heap_free_percent, heap_percent);
+
+    if (free_percent < CONFIG_ZSW_MEM_PRESSURE_CRITICAL_PERCENT) {
+        return ZSW_MEM_PRESSURE_CRITICAL;
+    } else if (free_percent < CONFIG_ZSW_MEM_PRESSURE_MODERATE_PERCENT) {
+        return ZSW_MEM_PRESSURE_MODERATE;
+    }
+    return ZSW_MEM_PRESSURE_NONE;
+}
+
+#ifdef CONFIG_ZSW_MEM_PRESSURE_SHED
+static zsw_mem_pressure_level_t shed(zsw_mem_pressure_level_t level)
+{
+    k_mutex_lock(&handlers_lock, K_FOREVER);
+    for (int i = 0; i < num_handlers && level != ZSW_MEM_PRESSURE_NONE; i++) {
+        if (handlers[i]->level > level) {
+            continue;
+        }
+        LOG_DBG("Shed %s at %s pressure", handlers[i]->name, level_names[level]);
+        handlers[i]->shed(level);
+        handlers[i]->num_sheds++;
+        stats.num_sheds++;
+        level = measure();
+    }
+    k_mutex_unlock(&handlers_lock);
+
+    return level;
+}
+#endif
+
+static void set_level(zsw_mem_pressure_level_t level)
+{
+    struct mem_pressure_event evt = {
+        .level = level,
+    };
+
+    if (level == stats.level) {
+        return;
+    }
+
+    LOG_INF("Memory pressure %s (LVGL largest free %d%%, heap free %d%%)", level_names[level], lvgl_free_percent(),
+            heap_free_percent());
+    stats.level = level;
+    stats.max_level = MAX(stats.max_level, level);
+    stats.num_level_changes++;
+    zbus_chan_pub(&mem_pressure_data_chan, &evt, K_MSEC(250));
+}
+
+static void handle_check_work(struct k_work *item)
+{
+    zsw_mem_pressure_level_t level = measure();
+
+#ifdef CONFIG_ZSW_MEM_PRESSURE_SHED
+    if (level != ZSW_MEM_PRESSURE_NONE) {
+        level = shed(level);
+    }
+#endif
+    set_level(level);
+
+    if (level != ZSW_MEM_PRESSURE_NONE) {
+        k_work_schedule(&check_work, K_SECONDS(RECHECK_INTERVAL_S));
+    }
+}
+
+int zsw_mem_pressure_register(zsw_mem_pressure_handler_t *handler)
+{
+    int i;
+
+    __ASSERT_NO_MSG(handler->shed);
+
+    k_mutex_lock(&handlers_lock, K_FOREVER);
+    if (num_handlers >= ARRAY_SIZE(handlers)) {
+        k_mutex_unlock(&handlers_lock);
+        return -ENOMEM;
+    }
+    // Keep sorted on priority, same priority in registration order.
+    for (i = num_handlers; i > 0 && handlers[i - 1]->priority > handler->priority; i--) {
+        handlers[i] = handlers[i - 1];
+    }
+    handlers[i] = handler;
+    num_handlers++;
+    k_mutex_unlock(&handlers_lock);
+
+    return 0;
+}
+
+void zsw_mem_pressure_check(void)
+{
+    k_work_reschedule(&check_work, K_NO_WAIT);
+}
+
+void zsw_mem_pressure_report_alloc_failure(const char *what, size_t size)
+{
+    stats.num_alloc_failures++;
+    LOG_WRN("%s: failed to allocate %d bytes", what, size);
+    zsw_mem_pressure_check();
+}
+
+zsw_mem_pressure_level_t zsw_mem_pressure_get_level(void)
+{
+    return stats.level;
+}
+
+void zsw_mem_pressure_get_stats(zsw_mem_pressure_stats_t *out)
+{
+    *out = stats;
+}
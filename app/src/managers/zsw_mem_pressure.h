@@ -0,0 +1,87 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_MEM_PRESSURE_H_
+#define __ZSW_MEM_PRESSURE_H_
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+*   Memory pressure is the lowest of the largest free LVGL block and the free
+*   system heap, in percent of each pool. Levels are entered below
+*   CONFIG_ZSW_MEM_PRESSURE_MODERATE_PERCENT and
+*   CONFIG_ZSW_MEM_PRESSURE_CRITICAL_PERCENT. Changes are published on
+*   mem_pressure_data_chan.
+*/
+typedef enum zsw_mem_pressure_level_t {
+    ZSW_MEM_PRESSURE_NONE,
+    ZSW_MEM_PRESSURE_MODERATE,
+    ZSW_MEM_PRESSURE_CRITICAL,
+    ZSW_MEM_PRESSURE_NUM,
+} zsw_mem_pressure_level_t;
+
+/*
+*   A subsystem that can give memory back. When the pressure reaches level,
+*   shed is called in priority order, lowest first, and the pressure is
+*   measured again after each call. Shedding stops as soon as the pressure
+*   is below the level the next handler needs. Put caches that are cheap to
+*   rebuild first and things the user notices last.
+*/
+typedef struct zsw_mem_pressure_handler_t {
+    const char *name;
+    zsw_mem_pressure_level_t level;
+    uint8_t priority;
+    void (*shed)(zsw_mem_pressure_level_t level); // Called from the LVGL thread.
+    // Internal, zero initialize.
+    uint32_t num_sheds;
+} zsw_mem_pressure_handler_t;
+
+typedef struct zsw_mem_pressure_stats_t {
+    zsw_mem_pressure_level_t level;
+    zsw_mem_pressure_level_t max_level;
+    uint32_t num_level_changes;
+    uint32_t num_sheds;
+    uint32_t num_alloc_failures; // As reported with zsw_mem_pressure_report_alloc_failure.
+    uint8_t min_lvgl_free_percent; // Lowest largest free LVGL block seen.
+    uint8_t min_heap_free_percent;
+} zsw_mem_pressure_stats_t;
+
+/*
+*   Register a handler. The handler struct must stay valid forever.
+*   Returns 0 or -ENOMEM if CONFIG_ZSW_MEM_PRESSURE_MAX_HANDLERS are registered.
+*/
+int zsw_mem_pressure_register(zsw_mem_pressure_handler_t *handler);
+
+/*
+*   Measure the pressure and shed if needed. The measurement runs on the
+*   system workqueue, so it may be called from any thread. Call after
+*   something that allocates a lot, like starting an app.
+*/
+void zsw_mem_pressure_check(void);
+
+/*
+*   Call when an allocation failed. It is counted and a check is started so
+*   the next attempt is more likely to succeed.
+*/
+void zsw_mem_pressure_report_alloc_failure(const char *what, size_t size);
+
+zsw_mem_pressure_level_t zsw_mem_pressure_get_level(void);
+
+void zsw_mem_pressure_get_stats(zsw_mem_pressure_stats_t *stats);
+
+#endif // __ZSW_MEM_PRESSURE_H_
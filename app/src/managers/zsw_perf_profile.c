@@ -0,0 +1,122 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/logging/log.h>
+
+#include "events/battery_event.h"
+#include "events/chg_event.h"
+#include "events/perf_profile_event.h"
+#include "managers/zsw_perf_profile.h"
+
+LOG_MODULE_REGISTER(zsw_perf_profile, LOG_LEVEL_INF);
+
+static void zbus_battery_sample_callback(const struct zbus_channel *chan);
+static void zbus_chg_state_callback(const struct zbus_channel *chan);
+
+ZBUS_CHAN_DECLARE(battery_sample_data_chan);
+ZBUS_CHAN_DECLARE(chg_state_data_chan);
+ZBUS_CHAN_DECLARE(perf_profile_data_chan);
+ZBUS_LISTENER_DEFINE(zsw_perf_profile_battery_lis, zbus_battery_sample_callback);
+ZBUS_LISTENER_DEFINE(zsw_perf_profile_chg_lis, zbus_chg_state_callback);
+
+static const zsw_perf_profile_policy_t policies[ZSW_PERF_PROFILE_NUM] = {
+    [ZSW_PERF_PROFILE_NORMAL] = {
+        .max_brightness = 100,
+        .max_vibration_percent = 100,
+        .animations = true,
+        .ble_short_conn_interval = true,
+        .periodic_fast_interval_ms = 100,
+        .gatt_sensor_stream_divider = 1,
+        .bsec_lp_allowed = true,
+    },
+    [ZSW_PERF_PROFILE_LOW_BATTERY] = {
+        .max_brightness = 30,
+        .max_vibration_percent = 60,
+        .animations = false,
+        .ble_short_conn_interval = false,
+        .periodic_fast_interval_ms = 250,
+        .gatt_sensor_stream_divider = 4,
+        .bsec_lp_allowed = false,
+    },
+};
+
+static zsw_perf_profile_t profile = ZSW_PERF_PROFILE_NORMAL;
+static int battery_percent = -1;
+static bool is_charging;
+
+zsw_perf_profile_t zsw_perf_profile_get(void)
+{
+    return profile;
+}
+
+const zsw_perf_profile_policy_t *zsw_perf_profile_get_policy(void)
+{
+    return &policies[profile];
+}
+
+static void update_profile(void)
+{
+    zsw_perf_profile_t new_profile = profile;
+
+    if (is_charging || battery_percent < 0) {
+        new_profile = ZSW_PERF_PROFILE_NORMAL;
+    } else if (battery_percent <= CONFIG_ZSW_LOW_BATTERY_ENTER_PERCENT) {
+        new_profile = ZSW_PERF_PROFILE_LOW_BATTERY;
+    } else if (battery_percent >= CONFIG_ZSW_LOW_BATTERY_EXIT_PERCENT) {
+        new_profile = ZSW_PERF_PROFILE_NORMAL;
+    }
+
+    if (new_profile != profile) {
+        struct perf_profile_event evt = {
+            .profile = new_profile,
+        };
+
+        LOG_INF("Performance profile %s (battery %d%%, charging %d)",
+                new_profile == ZSW_PERF_PROFILE_LOW_BATTERY ? "low battery" : "normal", battery_percent, is_charging);
+        profile = new_profile;
+        zbus_chan_pub(&perf_profile_data_chan, &evt, K_MSEC(250));
+    }
+}
+
+static void zbus_battery_sample_callback(const struct zbus_channel *chan)
+{
+    const struct battery_sample_event *event = zbus_chan_const_msg(chan);
+
+    battery_percent = event->percent;
+    update_profile();
+}
+
+static void zbus_chg_state_callback(const struct zbus_channel *chan)
+{
+    const struct chg_state_event *event = zbus_chan_const_msg(chan);
+
+    is_charging = event->is_charging;
+    update_profile();
+}
+
+static int zsw_perf_profile_init(void)
+{
+    zbus_chan_add_obs(&battery_sample_data_chan, &zsw_perf_profile_battery_lis, K_MSEC(100));
+    zbus_chan_add_obs(&chg_state_data_chan, &zsw_perf_profile_chg_lis, K_MSEC(100));
+
+    return 0;
+}
+
+SYS_INIT(zsw_perf_profile_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,56 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_PERF_PROFILE_H_
+#define __ZSW_PERF_PROFILE_H_
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum zsw_perf_profile_t {
+    ZSW_PERF_PROFILE_NORMAL,
+    ZSW_PERF_PROFILE_LOW_BATTERY,
+    ZSW_PERF_PROFILE_NUM,
+} zsw_perf_profile_t;
+
+/*
+*   What each subsystem is allowed to do in a profile. All values for all
+*   profiles are set in one table in zsw_perf_profile.c.
+*/
+typedef struct zsw_perf_profile_policy_t {
+    uint8_t max_brightness; // Backlight ceiling in percent.
+    uint8_t max_vibration_percent; // Vibration patterns are scaled to this.
+    bool animations; // Screen transition animations.
+    bool ble_short_conn_interval; // Allow requests for short BLE connection interval.
+    uint32_t periodic_fast_interval_ms; // Period of periodic_event_fast_chan, drives app sensor polling.
+    uint8_t gatt_sensor_stream_divider; // GATT sensor stream sends every Nth fast period.
+    bool bsec_lp_allowed; // Allow BSEC LP sample rate, otherwise always ULP.
+} zsw_perf_profile_policy_t;
+
+/*
+*   Returns the active profile. Low battery is entered at
+*   CONFIG_ZSW_LOW_BATTERY_ENTER_PERCENT and left at
+*   CONFIG_ZSW_LOW_BATTERY_EXIT_PERCENT or when charging starts.
+*   Changes are published on perf_profile_data_chan.
+*/
+zsw_perf_profile_t zsw_perf_profile_get(void);
+
+/*
+*   Returns the policy for the active profile.
+*/
+const zsw_perf_profile_policy_t *zsw_perf_profile_get_policy(void);
+
+#endif // __ZSW_PERF_PROFILE_H_
@@ -38,12 +38,34 @@ LOG_MODULE_REGISTER(zsw_power_manager, LOG_LEVEL_INF);
 #define IDLE_TIMEOUT_SECONDS    CONFIG_POWER_MANAGEMENT_IDLE_TIMEOUT_SECONDS
 #endif
 
+#define HOOK_WORKER_STACK_SIZE  2048
+
+typedef struct hook_job_t {
+    zsw_power_manager_hook_t   *hook;
+    bool                        suspend;
+} hook_job_t;
+
 static void update_and_publish_state(zsw_power_manager_state_t new_state);
 static void handle_idle_timeout(struct k_work *item);
 static void zbus_accel_data_callback(const struct zbus_channel *chan);
+static void hook_worker_thread(void *, void *, void *);
+static int display_suspend(void);
+static int display_resume(void);
+static int imu_suspend(void);
+static int imu_resume(void);
+static int cpu_freq_suspend(void);
+static int cpu_freq_resume(void);
 
 K_WORK_DELAYABLE_DEFINE(idle_work, handle_idle_timeout);
 
+// The thread doing the transition runs one hook itself while the worker runs
+// the rest of the phase one by one, so at most two hooks run at the same time.
+K_THREAD_DEFINE(hook_worker_tid, HOOK_WORKER_STACK_SIZE, hook_worker_thread, NULL, NULL, NULL,
+                CONFIG_SYSTEM_WORKQUEUE_PRIORITY, 0, 0);
+K_MSGQ_DEFINE(hook_job_msgq, sizeof(hook_job_t), CONFIG_POWER_MANAGEMENT_MAX_HOOKS, 4);
+K_SEM_DEFINE(hook_done_sem, 0, CONFIG_POWER_MANAGEMENT_MAX_HOOKS);
+K_MUTEX_DEFINE(transition_mutex);
+
 ZBUS_CHAN_DECLARE(activity_state_data_chan);
 
 ZBUS_CHAN_DECLARE(accel_data_chan);
@@ -56,37 +78,169 @@ static uint32_t last_wakeup_time;
 static uint32_t last_pwr_off_time;
 static zsw_power_manager_state_t state;
 
+static zsw_power_manager_hook_t *hooks[CONFIG_POWER_MANAGEMENT_MAX_HOOKS];
+static int num_hooks;
+static zsw_power_manager_transition_stats_t transition_stats;
+
+static zsw_power_manager_hook_t display_hook = {
+    .name = "display",
+    .phase = ZSW_POWER_MANAGER_PHASE_NORMAL,
+    .suspend = display_suspend,
+    .resume = display_resume,
+    .budget_ms = 50,
+};
+
+static zsw_power_manager_hook_t imu_hook = {
+    .name = "imu",
+    .phase = ZSW_POWER_MANAGER_PHASE_NORMAL,
+    .suspend = imu_suspend,
+    .resume = imu_resume,
+    .budget_ms = 20,
+};
+
+static zsw_power_manager_hook_t cpu_freq_hook = {
+    .name = "cpu_freq",
+    .phase = ZSW_POWER_MANAGER_PHASE_LATE,
+    .suspend = cpu_freq_suspend,
+    .resume = cpu_freq_resume,
+    .budget_ms = 5,
+};
+
+static void run_hook(zsw_power_manager_hook_t *hook, bool suspend)
+{
+    int ret;
+    uint32_t start = k_cycle_get_32();
+    uint32_t duration_us;
+
+    ret = suspend ? hook->suspend() : hook->resume();
+    duration_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    if (suspend) {
+        hook->last_suspend_us = duration_us;
+    } else {
+        hook->last_resume_us = duration_us;
+    }
+
+    if (ret != 0) {
+        LOG_ERR("%s %s failed: %d", hook->name, suspend ? "suspend" : "resume", ret);
+    }
+    if (hook->budget_ms != 0 && duration_us > hook->budget_ms * 1000) {
+        LOG_WRN("%s %s took %d us, budget %d ms", hook->name, suspend ? "suspend" : "resume", duration_us,
+                hook->budget_ms);
+    }
+}
+
+static void hook_worker_thread(void *, void *, void *)
+{
+    hook_job_t job;
+
+    while (1) {
+        k_msgq_get(&hook_job_msgq, &job, K_FOREVER);
+        run_hook(job.hook, job.suspend);
+        k_sem_give(&hook_done_sem);
+    }
+}
+
+static uint32_t run_phase(zsw_power_manager_phase_t phase, bool suspend)
+{
+    int num_queued = 0;
+    uint32_t start = k_cycle_get_32();
+    zsw_power_manager_hook_t *own_hook = NULL;
+
+    for (int i = 0; i < num_hooks; i++) {
+        if (hooks[i]->phase != phase || (suspend ? hooks[i]->suspend : hooks[i]->resume) == NULL) {
+            continue;
+        }
+        if (own_hook == NULL) {
+            own_hook = hooks[i];
+        } else {
+            hook_job_t job = {
+                .hook = hooks[i],
+                .suspend = suspend,
+            };
+            // Queue fits all hooks, can't fail.
+            k_msgq_put(&hook_job_msgq, &job, K_NO_WAIT);
+            num_queued++;
+        }
+    }
+
+    if (own_hook) {
+        run_hook(own_hook, suspend);
+    }
+
+    while (num_queued > 0) {
+        k_sem_take(&hook_done_sem, K_FOREVER);
+        num_queued--;
+    }
+
+    return k_cyc_to_us_floor32(k_cycle_get_32() - start);
+}
+
+static uint32_t run_hooks(bool suspend)
+{
+    uint32_t total_us = 0;
+    uint32_t *phase_us = suspend ? transition_stats.last_suspend_phase_us : transition_stats.last_resume_phase_us;
+
+    for (int i = 0; i < ZSW_POWER_MANAGER_PHASE_NUM; i++) {
+        zsw_power_manager_phase_t phase = suspend ? i : ZSW_POWER_MANAGER_PHASE_NUM - 1 - i;
+        phase_us[phase] = run_phase(phase, suspend);
+        total_us += phase_us[phase];
+    }
+
+    return total_us;
+}
+
+// Must be called with transition_mutex held.
 static void enter_inactive(void)
 {
+    uint32_t start = k_cycle_get_32();
+    uint32_t hooks_us;
+
     LOG_INF("Enter inactive");
     is_active = false;
     retained.wakeup_time += k_uptime_get_32() - last_wakeup_time;
     zsw_retained_ram_update();
-    zsw_display_control_sleep_ctrl(false);
 
-    zsw_cpu_set_freq(ZSW_CPU_FREQ_DEFAULT, true);
-
-    // Screen inactive -> wait for NO_MOTION interrupt in order to power off display regulator.
-    zsw_imu_feature_enable(ZSW_IMU_FEATURE_NO_MOTION, true);
-    zsw_imu_feature_disable(ZSW_IMU_FEATURE_ANY_MOTION);
+    hooks_us = run_hooks(true);
 
     update_and_publish_state(ZSW_ACTIVITY_STATE_INACTIVE);
+
+    transition_stats.last_suspend_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    transition_stats.max_suspend_us = MAX(transition_stats.max_suspend_us, transition_stats.last_suspend_us);
+    LOG_DBG("Inactive in %d us (hooks %d us)", transition_stats.last_suspend_us, hooks_us);
 }
 
+// Must be called with transition_mutex held.
 static void enter_active(void)
 {
+    uint32_t start = k_cycle_get_32();
+    uint32_t hooks_us;
+
     LOG_INF("Enter active");
-    int ret;
 
     is_active = true;
     is_stationary = false;
     last_wakeup_time = k_uptime_get_32();
 
-    // Running at max CPU freq consumes more power, but rendering we
-    // want to do as fast as possible. Also to use 32MHz SPI, CPU has
-    // to be running at 128MHz. Meaning this improves both rendering times
-    // and the SPI transmit time.
-    zsw_cpu_set_freq(ZSW_CPU_FREQ_FAST, true);
+    hooks_us = run_hooks(false);
+
+    update_and_publish_state(ZSW_ACTIVITY_STATE_ACTIVE);
+
+    k_work_schedule(&idle_work, K_SECONDS(idle_timeout_seconds));
+
+    transition_stats.last_resume_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    transition_stats.max_resume_us = MAX(transition_stats.max_resume_us, transition_stats.last_resume_us);
+    LOG_DBG("Active in %d us (hooks %d us)", transition_stats.last_resume_us, hooks_us);
+}
+
+static int display_suspend(void)
+{
+    return zsw_display_control_sleep_ctrl(false);
+}
+
+static int display_resume(void)
+{
+    int ret;
 
     ret = zsw_display_control_pwr_ctrl(true);
     zsw_display_control_sleep_ctrl(true);
@@ -96,26 +250,85 @@ static void enter_active(void)
         zsw_retained_ram_update();
     }
 
+    return 0;
+}
+
+static int imu_suspend(void)
+{
+    // Screen inactive -> wait for NO_MOTION interrupt in order to power off display regulator.
+    zsw_imu_feature_enable(ZSW_IMU_FEATURE_NO_MOTION, true);
+    zsw_imu_feature_disable(ZSW_IMU_FEATURE_ANY_MOTION);
+
+    return 0;
+}
+
+static int imu_resume(void)
+{
     // Only used when display is not active.
     zsw_imu_feature_disable(ZSW_IMU_FEATURE_NO_MOTION);
     zsw_imu_feature_disable(ZSW_IMU_FEATURE_ANY_MOTION);
 
-    update_and_publish_state(ZSW_ACTIVITY_STATE_ACTIVE);
+    return 0;
+}
 
-    k_work_schedule(&idle_work, K_SECONDS(idle_timeout_seconds));
+static int cpu_freq_suspend(void)
+{
+    zsw_cpu_set_freq(ZSW_CPU_FREQ_DEFAULT, true);
+
+    return 0;
+}
+
+static int cpu_freq_resume(void)
+{
+    // Running at max CPU freq consumes more power, but rendering we
+    // want to do as fast as possible. Also to use 32MHz SPI, CPU has
+    // to be running at 128MHz. Meaning this improves both rendering times
+    // and the SPI transmit time.
+    zsw_cpu_set_freq(ZSW_CPU_FREQ_FAST, true);
+
+    return 0;
+}
+
+int zsw_power_manager_register_hook(zsw_power_manager_hook_t *hook)
+{
+    int ret = 0;
+
+    k_mutex_lock(&transition_mutex, K_FOREVER);
+    if (num_hooks >= ARRAY_SIZE(hooks)) {
+        ret = -ENOMEM;
+    } else {
+        hooks[num_hooks++] = hook;
+    }
+    k_mutex_unlock(&transition_mutex);
+
+    return ret;
+}
+
+void zsw_power_manager_get_transition_stats(zsw_power_manager_transition_stats_t *stats)
+{
+    k_mutex_lock(&transition_mutex, K_FOREVER);
+    memcpy(stats, &transition_stats, sizeof(transition_stats));
+    k_mutex_unlock(&transition_mutex);
 }
 
 bool zsw_power_manager_reset_idle_timout(void)
 {
+    bool woke_up;
+
+    // Checked under the mutex so concurrent callers can't both wake up.
+    k_mutex_lock(&transition_mutex, K_FOREVER);
     if (!is_active) {
         // If we are inactive, then this means we we should enter active.
         enter_active();
-        return true;
+        woke_up = true;
     } else {
         // We are active, then just reschdule the inactivity timeout.
         k_work_reschedule(&idle_work, K_SECONDS(idle_timeout_seconds));
-        return false;
+        woke_up = false;
     }
+    k_mutex_unlock(&transition_mutex);
+
+    return woke_up;
 }
 
 uint32_t zsw_power_manager_get_ms_to_inactive(void)
@@ -152,17 +365,24 @@ static void handle_idle_timeout(struct k_work *item)
 {
     uint32_t last_lvgl_activity_ms = lv_disp_get_inactive_time(NULL);
 
-    if (last_lvgl_activity_ms > idle_timeout_seconds * 1000) {
+    k_mutex_lock(&transition_mutex, K_FOREVER);
+    if (!is_active) {
+        // Already went inactive, nothing to do.
+    } else if (last_lvgl_activity_ms > idle_timeout_seconds * 1000) {
         enter_inactive();
     } else {
         k_work_schedule(&idle_work, K_MSEC(idle_timeout_seconds * 1000 - last_lvgl_activity_ms));
     }
+    k_mutex_unlock(&transition_mutex);
 }
 
 static void zbus_accel_data_callback(const struct zbus_channel *chan)
 {
     const struct accel_event *event = zbus_chan_const_msg(chan);
 
+    // The motion events change display power and state, which must not
+    // interleave with a transition running in another thread.
+    k_mutex_lock(&transition_mutex, K_FOREVER);
     switch (event->data.type) {
         case ZSW_IMU_EVT_TYPE_WRIST_WAKEUP: {
             if (!is_active) {
@@ -201,6 +421,7 @@ static void zbus_accel_data_callback(const struct zbus_channel *chan)
         default:
             break;
     }
+    k_mutex_unlock(&transition_mutex);
 }
 
 static int settings_load_handler(const char *key, size_t len,
@@ -227,6 +448,11 @@ static int zsw_power_manager_init(void)
 
     last_wakeup_time = k_uptime_get_32();
     last_pwr_off_time = k_uptime_get_32();
+
+    zsw_power_manager_register_hook(&display_hook);
+    zsw_power_manager_register_hook(&imu_hook);
+    zsw_power_manager_register_hook(&cpu_freq_hook);
+
     settings_subsys_init();
     err = settings_load_subtree_direct(ZSW_SETTINGS_DISPLAY_ALWAYS_ON, settings_load_handler, &display_always_on);
     if (err == 0 && display_always_on) {
@@ -25,6 +25,49 @@ typedef enum zsw_power_manager_state_t {
     ZSW_ACTIVITY_STATE_NOT_WORN_STATIONARY,
 } zsw_power_manager_state_t;
 
+/*
+*   Hooks in the same phase have no order between them and up to two of them
+*   run at the same time, so a hook must not depend on another hook in its
+*   own phase. On suspend phases run from
+*   EARLY to LATE, on resume from LATE to EARLY. Put hooks other hooks depend
+*   on (e.g. CPU clock) in LATE so they are suspended last and resumed first.
+*/
+typedef enum zsw_power_manager_phase_t {
+    ZSW_POWER_MANAGER_PHASE_EARLY,
+    ZSW_POWER_MANAGER_PHASE_NORMAL,
+    ZSW_POWER_MANAGER_PHASE_LATE,
+    ZSW_POWER_MANAGER_PHASE_NUM,
+} zsw_power_manager_phase_t;
+
+typedef struct zsw_power_manager_hook_t {
+    const char *name;
+    zsw_power_manager_phase_t phase;
+    int (*suspend)(void); // Called when entering inactive, may be NULL.
+    int (*resume)(void); // Called when entering active, may be NULL.
+    uint32_t budget_ms; // Warning is logged if a call takes longer, 0 for no budget.
+    // Filled in by the power manager.
+    uint32_t last_suspend_us;
+    uint32_t last_resume_us;
+} zsw_power_manager_hook_t;
+
+typedef struct zsw_power_manager_transition_stats_t {
+    uint32_t last_suspend_us;
+    uint32_t last_resume_us;
+    uint32_t max_suspend_us;
+    uint32_t max_resume_us;
+    uint32_t last_suspend_phase_us[ZSW_POWER_MANAGER_PHASE_NUM];
+    uint32_t last_resume_phase_us[ZSW_POWER_MANAGER_PHASE_NUM];
+} zsw_power_manager_transition_stats_t;
+
+/*
+*   Register hooks to run when the watch enters inactive or active state.
+*   hook must stay valid forever. Returns -ENOMEM if
+*   CONFIG_POWER_MANAGEMENT_MAX_HOOKS hooks are already registered.
+*/
+int zsw_power_manager_register_hook(zsw_power_manager_hook_t *hook);
+
+void zsw_power_manager_get_transition_stats(zsw_power_manager_transition_stats_t *stats);
+
 /*
 *   Resets the inactivity timeout that will make the watch go
 *   into inactive mode with display etc. turned off to save power.
@@ -20,7 +20,12 @@
 
 #include "events/zsw_periodic_event.h"
 #include "events/environment_event.h"
+#include "events/activity_event.h"
+#include "events/chg_event.h"
+#include "managers/zsw_maintenance.h"
+#include "managers/zsw_perf_profile.h"
 #include "sensors/zsw_environment_sensor.h"
+#include "sensors/zsw_sensor_history.h"
 
 #include "../../drivers/sensor/bme68x_iaq/bosch_bme68x_iaq.h"
 
@@ -33,6 +38,125 @@ ZBUS_CHAN_DECLARE(periodic_event_slow_chan);
 ZBUS_LISTENER_DEFINE(zsw_environment_sensor_lis, zbus_periodic_slow_callback);
 static const struct device *const bme688 = DEVICE_DT_GET_OR_NULL(DT_NODELABEL(bme688));
 
+#ifdef CONFIG_EXTERNAL_USE_BOSCH_BSEC
+static void save_bsec_state(void);
+
+/*
+* Writing the BSEC state to flash is deferred to when the watch is on the charger,
+* instead of on a fixed interval in the driver. At most one save per hour, and
+* never more than four hours late if the watch is not charged.
+*/
+static zsw_maintenance_task_t bsec_state_task = {
+    .name = "bsec_state",
+    .run = save_bsec_state,
+    .min_interval_s = 60 * 60,
+    .deadline_s = 4 * 60 * 60,
+};
+
+static void save_bsec_state(void)
+{
+    int ret;
+    struct sensor_value val = {0};
+
+    // Blocks until the BSEC thread has written the state, so the flash write
+    // happens inside the maintenance window and is part of the task duration.
+    ret = sensor_attr_set(bme688, SENSOR_CHAN_ALL, SENSOR_ATTR_BSEC_SAVE_STATE, &val);
+    if (ret != 0) {
+        LOG_ERR("Failed to save BSEC state: %d", ret);
+    }
+}
+#endif
+
+#ifdef CONFIG_ZSW_BSEC_ADAPTIVE_SAMPLE_RATE
+static void zbus_activity_event_callback(const struct zbus_channel *chan);
+static void zbus_chg_event_callback(const struct zbus_channel *chan);
+static void zbus_perf_profile_callback(const struct zbus_channel *chan);
+static void iaq_recent_view_timeout(struct k_work *work);
+
+ZBUS_CHAN_DECLARE(activity_state_data_chan);
+ZBUS_CHAN_DECLARE(chg_state_data_chan);
+ZBUS_CHAN_DECLARE(perf_profile_data_chan);
+ZBUS_LISTENER_DEFINE(zsw_environment_sensor_activity_lis, zbus_activity_event_callback);
+ZBUS_LISTENER_DEFINE(zsw_environment_sensor_chg_lis, zbus_chg_event_callback);
+ZBUS_LISTENER_DEFINE(zsw_environment_sensor_perf_profile_lis, zbus_perf_profile_callback);
+
+static K_WORK_DELAYABLE_DEFINE(iaq_recent_view_work, iaq_recent_view_timeout);
+
+static bool iaq_viewed;
+static bool iaq_recently_viewed;
+static bool is_worn = true;
+static bool is_charging;
+static int current_sample_rate = -1;
+
+/*
+* BSEC runs in LP mode (3 s) while IAQ is shown and for a while after, as long as
+* the watch is worn and not charging. Otherwise, and always in the low battery
+* profile, ULP (300 s) keeps the BME688 heater and the BSEC thread mostly idle.
+* The IAQ calibration is kept in both modes.
+*/
+static void update_bsec_sample_rate(void)
+{
+    struct sensor_value val;
+    struct sensor_value heater_on_ms;
+    struct sensor_value wakeups;
+
+    if (!device_is_ready(bme688)) {
+        return;
+    }
+
+    if (!zsw_perf_profile_get_policy()->bsec_lp_allowed) {
+        val.val1 = BME68X_IAQ_SAMPLE_RATE_ULP;
+    } else if (iaq_viewed || (iaq_recently_viewed && is_worn && !is_charging)) {
+        val.val1 = BME68X_IAQ_SAMPLE_RATE_LP;
+    } else {
+        val.val1 = BME68X_IAQ_SAMPLE_RATE_ULP;
+    }
+    val.val2 = 0;
+
+    if (val.val1 == current_sample_rate) {
+        return;
+    }
+
+    if (sensor_attr_set(bme688, SENSOR_CHAN_ALL, SENSOR_ATTR_BSEC_SAMPLE_RATE, &val) != 0) {
+        LOG_ERR("Failed to set BSEC sample rate");
+        return;
+    }
+    current_sample_rate = val.val1;
+
+    if (zsw_environment_sensor_get_bsec_stats(&heater_on_ms, &wakeups) == 0) {
+        LOG_INF("BSEC %s, heater on %d s, %d thread wakeups since boot",
+                current_sample_rate == BME68X_IAQ_SAMPLE_RATE_LP ? "LP" : "ULP", heater_on_ms.val1 / 1000, wakeups.val1);
+    }
+}
+
+static void iaq_recent_view_timeout(struct k_work *work)
+{
+    iaq_recently_viewed = false;
+    update_bsec_sample_rate();
+}
+
+static void zbus_activity_event_callback(const struct zbus_channel *chan)
+{
+    const struct activity_state_event *event = zbus_chan_const_msg(chan);
+
+    is_worn = event->state != ZSW_ACTIVITY_STATE_NOT_WORN_STATIONARY;
+    update_bsec_sample_rate();
+}
+
+static void zbus_chg_event_callback(const struct zbus_channel *chan)
+{
+    const struct chg_state_event *event = zbus_chan_const_msg(chan);
+
+    is_charging = event->is_charging;
+    update_bsec_sample_rate();
+}
+
+static void zbus_perf_profile_callback(const struct zbus_channel *chan)
+{
+    update_bsec_sample_rate();
+}
+#endif
+
 static void zbus_periodic_slow_callback(const struct zbus_channel *chan)
 {
     float temperature;
@@ -54,6 +178,10 @@ static void zbus_periodic_slow_callback(const struct zbus_channel *chan)
         .iaq = iaq
     };
     zbus_chan_pub(&environment_data_chan, &evt, K_MSEC(250));
+
+#ifdef CONFIG_EXTERNAL_USE_BOSCH_BSEC
+    zsw_maintenance_request(&bsec_state_task);
+#endif
 }
 
 int zsw_environment_sensor_init(void)
@@ -65,9 +193,47 @@ int zsw_environment_sensor_init(void)
 
     zsw_periodic_chan_add_obs(&periodic_event_slow_chan, &zsw_environment_sensor_lis);
 
+#ifdef CONFIG_EXTERNAL_USE_BOSCH_BSEC
+    zsw_maintenance_register(&bsec_state_task);
+#endif
+
+#ifdef CONFIG_ZSW_BSEC_ADAPTIVE_SAMPLE_RATE
+    zbus_chan_add_obs(&activity_state_data_chan, &zsw_environment_sensor_activity_lis, K_MSEC(100));
+    zbus_chan_add_obs(&chg_state_data_chan, &zsw_environment_sensor_chg_lis, K_MSEC(100));
+    zbus_chan_add_obs(&perf_profile_data_chan, &zsw_environment_sensor_perf_profile_lis, K_MSEC(100));
+    update_bsec_sample_rate();
+#endif
+
     return 0;
 }
 
+void zsw_environment_sensor_set_iaq_viewed(bool viewed)
+{
+#ifdef CONFIG_ZSW_BSEC_ADAPTIVE_SAMPLE_RATE
+    iaq_viewed = viewed;
+    if (viewed) {
+        iaq_recently_viewed = true;
+        k_work_cancel_delayable(&iaq_recent_view_work);
+    } else {
+        k_work_reschedule(&iaq_recent_view_work, K_MINUTES(CONFIG_ZSW_BSEC_IAQ_RECENT_VIEW_MINUTES));
+    }
+    update_bsec_sample_rate();
+#endif
+}
+
+int zsw_environment_sensor_get_bsec_stats(struct sensor_value *heater_on_ms, struct sensor_value *wakeups)
+{
+    if (!IS_ENABLED(CONFIG_EXTERNAL_USE_BOSCH_BSEC) || !device_is_ready(bme688)) {
+        return -ENODEV;
+    }
+
+    if (sensor_attr_get(bme688, SENSOR_CHAN_ALL, SENSOR_ATTR_BSEC_HEATER_ON_MS, heater_on_ms) != 0) {
+        return -ENODATA;
+    }
+
+    return sensor_attr_get(bme688, SENSOR_CHAN_ALL, SENSOR_ATTR_BSEC_WAKEUPS, wakeups);
+}
+
 int zsw_environment_sensor_get(float *temperature, float *humidity, float *pressure)
 {
     struct sensor_value sensor_val;
@@ -95,6 +261,9 @@ int zsw_environment_sensor_get(float *temperature, float *humidity, float *press
     }
     *pressure = sensor_value_to_float(&sensor_val);
 
+    float values[] = { *temperature, *humidity, *pressure };
+    zsw_sensor_history_push(ZSW_SENSOR_HISTORY_ENVIRONMENT, values, ARRAY_SIZE(values));
+
     return 0;
 }
 
@@ -27,4 +27,15 @@ int zsw_environment_sensor_get_iaq(float *iaq);
 
 int zsw_environment_sensor_get_voc(float *voc);
 
-int zsw_environment_sensor_get_co2(float *co2);
\ No newline at end of file
+int zsw_environment_sensor_get_co2(float *co2);
+
+/*
+* Tell the sensor that IAQ is shown to the user, used to select the BSEC sample rate.
+*/
+void zsw_environment_sensor_set_iaq_viewed(bool viewed);
+
+/*
+* BME688 heater on time in ms and BSEC thread wakeups since boot.
+* Return -ENODEV if the Bosch BSEC driver is not used.
+*/
+int zsw_environment_sensor_get_bsec_stats(struct sensor_value *heater_on_ms, struct sensor_value *wakeups);
\ No newline at end of file
@@ -23,6 +23,9 @@
 #include "events/zsw_periodic_event.h"
 #include "events/accel_event.h"
 #include "sensors/zsw_imu.h"
+#include "sensors/zsw_sensor_history.h"
+#include "zsw_cycle_prof.h"
+#include "zsw_ram_code.h"
 
 LOG_MODULE_REGISTER(zsw_imu, CONFIG_ZSW_SENSORS_LOG_LEVEL);
 
@@ -41,9 +44,10 @@ static void zbus_periodic_slow_callback(const struct zbus_channel *chan)
     zbus_chan_pub(&accel_data_chan, &evt, K_MSEC(250));
 }
 
-static void bmi270_trigger_handler(const struct device *dev, const struct sensor_trigger *trig)
+static ZSW_HOT_FUNC void bmi270_trigger_handler(const struct device *dev, const struct sensor_trigger *trig)
 {
     zsw_imu_evt_t evt;
+    uint64_t prof_start = zsw_cycle_prof_begin();
 
     LOG_DBG("BMI270 trigger handler. Type: %u", trig->type);
 
@@ -118,6 +122,7 @@ static void bmi270_trigger_handler(const struct device *dev, const struct sensor
     }
 
     zbus_chan_pub(&accel_data_chan, &evt, K_MSEC(250));
+    zsw_cycle_prof_end(ZSW_CYCLE_PROF_IMU_TRIGGER, prof_start);
 }
 
 int zsw_imu_init(void)
@@ -164,6 +169,9 @@ int zsw_imu_fetch_accel_f(float *x, float *y, float *z)
     *y = sensor_value_to_float(&y_temp);
     *z = sensor_value_to_float(&z_temp);
 
+    float values[] = { *x, *y, *z };
+    zsw_sensor_history_push(ZSW_SENSOR_HISTORY_ACCEL, values, ARRAY_SIZE(values));
+
     return 0;
 }
 
@@ -218,6 +226,9 @@ int zsw_imu_fetch_accel(int16_t *x, int16_t *y, int16_t *z)
     *y = y_temp.val1;
     *z = z_temp.val1;
 
+    float values[] = { sensor_value_to_float(&x_temp), sensor_value_to_float(&y_temp), sensor_value_to_float(&z_temp) };
+    zsw_sensor_history_push(ZSW_SENSOR_HISTORY_ACCEL, values, ARRAY_SIZE(values));
+
     return 0;
 }
 
@@ -21,6 +21,7 @@
 #include "events/zsw_periodic_event.h"
 #include "events/light_event.h"
 #include "sensors/zsw_light_sensor.h"
+#include "sensors/zsw_sensor_history.h"
 
 LOG_MODULE_REGISTER(zsw_light_sensor, CONFIG_ZSW_SENSORS_LOG_LEVEL);
 
@@ -75,6 +76,7 @@ int zsw_light_sensor_get_light(float *light)
     }
 
     *light = sensor_value_to_float(&sensor_val);
+    zsw_sensor_history_push(ZSW_SENSOR_HISTORY_LIGHT, light, 1);
 
     return 0;
 }
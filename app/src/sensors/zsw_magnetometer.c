@@ -12,6 +12,7 @@
 #include "events/zsw_periodic_event.h"
 #include "events/magnetometer_event.h"
 #include "sensors/zsw_magnetometer.h"
+#include "sensors/zsw_sensor_history.h"
 
 LOG_MODULE_REGISTER(zsw_magnetometer, CONFIG_ZSW_SENSORS_LOG_LEVEL);
 
@@ -62,7 +63,7 @@ static void zbus_periodic_slow_callback(const struct zbus_channel *chan)
 
 // https://arduino.stackexchange.com/questions/18625/converting-three-axis-magnetometer-to-degrees/88707#88707
 // Note this assumes watch is flat to eath, TODO use accelerometer to compensate when tilted.
-static double xyz_to_rotation(double x, double y, double z)
+double zsw_magnetometer_xyz_to_heading(double x, double y, double z)
 {
     double heading = atan2(y, x) * 180 / M_PI;
     if (heading < 0) {
@@ -120,7 +121,10 @@ static void lis2mdl_trigger_handler(const struct device *dev,
     last_y = last_y - offset_y;
     last_z = last_z - offset_z;
 
-    last_heading = xyz_to_rotation(last_x, last_y, last_z);
+    last_heading = zsw_magnetometer_xyz_to_heading(last_x, last_y, last_z);
+
+    float values[] = { last_x, last_y, last_z };
+    zsw_sensor_history_push(ZSW_SENSOR_HISTORY_MAGNETOMETER, values, ARRAY_SIZE(values));
 
     LOG_DBG("Rotation: %f", last_heading);
 }
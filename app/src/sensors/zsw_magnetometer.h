@@ -22,6 +22,11 @@
 int zsw_magnetometer_init(void);
 int zsw_magnetometer_set_enable(bool enabled);
 double zsw_magnetometer_get_heading(void);
+/*
+*   Heading in degrees for calibrated magnetometer values, such as the
+*   ZSW_SENSOR_HISTORY_MAGNETOMETER samples.
+*/
+double zsw_magnetometer_xyz_to_heading(double x, double y, double z);
 int zsw_magnetometer_get_all(float *x, float *y, float *z);
 int zsw_magnetometer_start_calibration(void);
 int zsw_magnetometer_stop_calibration(void);
\ No newline at end of file
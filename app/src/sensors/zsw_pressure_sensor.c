@@ -21,6 +21,7 @@
 #include "events/pressure_event.h"
 #include "events/zsw_periodic_event.h"
 #include "sensors/zsw_pressure_sensor.h"
+#include "sensors/zsw_sensor_history.h"
 
 LOG_MODULE_REGISTER(zsw_pressure_sensor, CONFIG_ZSW_SENSORS_LOG_LEVEL);
 
@@ -92,6 +93,7 @@ int zsw_pressure_sensor_get_pressure(float *pressure)
     }
 
     *pressure = sensor_value_to_float(&sensor_val);
+    zsw_sensor_history_push(ZSW_SENSOR_HISTORY_PRESSURE, pressure, 1);
 
     return 0;
 }
@@ -0,0 +1,124 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+#include "sensors/zsw_sensor_history.h"
+
+LOG_MODULE_REGISTER(zsw_sensor_history, CONFIG_ZSW_SENSORS_LOG_LEVEL);
+
+#define HISTORY_LEN         CONFIG_ZSW_SENSOR_HISTORY_LEN
+#define READ_MAX_RETRIES    4
+
+typedef struct sensor_history_t {
+    // Odd while a write is in progress, readers retry if it changed during their copy.
+    atomic_t seq;
+    // Total number of samples pushed, newest sample is at (count - 1) % HISTORY_LEN.
+    uint32_t count;
+    zsw_sensor_history_sample_t samples[HISTORY_LEN];
+} sensor_history_t;
+
+static sensor_history_t histories[ZSW_SENSOR_HISTORY_NUM];
+static struct k_spinlock write_locks[ZSW_SENSOR_HISTORY_NUM];
+
+void zsw_sensor_history_push(zsw_sensor_history_stream_t stream, const float *values, uint8_t num_values)
+{
+    sensor_history_t *history = &histories[stream];
+    zsw_sensor_history_sample_t *sample;
+    k_spinlock_key_t key;
+
+    __ASSERT_NO_MSG(stream < ZSW_SENSOR_HISTORY_NUM);
+    num_values = MIN(num_values, ZSW_SENSOR_HISTORY_MAX_VALUES);
+
+    key = k_spin_lock(&write_locks[stream]);
+    atomic_inc(&history->seq);
+
+    sample = &history->samples[history->count % HISTORY_LEN];
+    sample->timestamp_ms = k_uptime_get_32();
+    memset(sample->values, 0, sizeof(sample->values));
+    memcpy(sample->values, values, num_values * sizeof(float));
+    history->count++;
+
+    atomic_inc(&history->seq);
+    k_spin_unlock(&write_locks[stream], key);
+}
+
+int zsw_sensor_history_read(zsw_sensor_history_stream_t stream, zsw_sensor_history_sample_t *samples,
+                            int max_samples, uint32_t max_age_ms)
+{
+    sensor_history_t *history = &histories[stream];
+    uint32_t now = k_uptime_get_32();
+    uint32_t count;
+    atomic_val_t seq;
+    int num;
+    int first;
+
+    __ASSERT_NO_MSG(stream < ZSW_SENSOR_HISTORY_NUM);
+
+    for (int retry = 0; retry < READ_MAX_RETRIES; retry++) {
+        seq = atomic_get(&history->seq);
+        if (seq & 1) {
+            k_yield();
+            continue;
+        }
+
+        count = history->count;
+        num = MIN(MIN(count, HISTORY_LEN), max_samples);
+        for (int i = 0; i < num; i++) {
+            samples[i] = history->samples[(count - num + i) % HISTORY_LEN];
+        }
+
+        if (atomic_get(&history->seq) != seq) {
+            continue;
+        }
+
+        if (max_age_ms == 0) {
+            return num;
+        }
+
+        // Drop samples that are too old, they are sorted oldest first.
+        for (first = 0; first < num && (now - samples[first].timestamp_ms) > max_age_ms; first++) {
+        }
+        if (first > 0) {
+            memmove(samples, &samples[first], (num - first) * sizeof(zsw_sensor_history_sample_t));
+        }
+
+        return num - first;
+    }
+
+    return -EAGAIN;
+}
+
+int zsw_sensor_history_get_latest(zsw_sensor_history_stream_t stream, zsw_sensor_history_sample_t *sample)
+{
+    int num = zsw_sensor_history_read(stream, sample, 1, 0);
+
+    if (num < 0) {
+        return num;
+    }
+
+    return num == 1 ? 0 : -ENODATA;
+}
+
+size_t zsw_sensor_history_get_ram_usage(void)
+{
+    return sizeof(histories) + sizeof(write_locks);
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ZSW_SENSOR_HISTORY_MAX_VALUES   3
+
+typedef enum zsw_sensor_history_stream_t {
+    ZSW_SENSOR_HISTORY_ACCEL,           // x, y, z
+    ZSW_SENSOR_HISTORY_MAGNETOMETER,    // x, y, z with calibration offset applied
+    ZSW_SENSOR_HISTORY_PRESSURE,        // pressure
+    ZSW_SENSOR_HISTORY_LIGHT,           // light
+    ZSW_SENSOR_HISTORY_ENVIRONMENT,     // temperature, humidity, pressure
+    ZSW_SENSOR_HISTORY_NUM
+} zsw_sensor_history_stream_t;
+
+typedef struct zsw_sensor_history_sample_t {
+    uint32_t timestamp_ms;
+    float values[ZSW_SENSOR_HISTORY_MAX_VALUES];
+} zsw_sensor_history_sample_t;
+
+/*
+* Recent history of every sensor stream, filled in by the sensor modules each time
+* they read the sensor. Lets several consumers look at the last samples without
+* causing any extra bus traffic.
+*
+* Writers are serialized per stream. Readers never take a lock, they retry if a
+* writer overwrote the samples they were copying.
+* RAM cost is CONFIG_ZSW_SENSOR_HISTORY_LEN * 16 + 8 bytes per stream.
+*/
+
+/*
+* Store a new sample, values not used by the stream are set to 0.
+*/
+void zsw_sensor_history_push(zsw_sensor_history_stream_t stream, const float *values, uint8_t num_values);
+
+/*
+* Copy up to max_samples of the most recent samples, oldest first.
+* Only samples newer than max_age_ms are returned, 0 means no age limit.
+*
+* Return number of samples copied, or -EAGAIN if writers kept changing the buffer.
+*/
+int zsw_sensor_history_read(zsw_sensor_history_stream_t stream, zsw_sensor_history_sample_t *samples,
+                            int max_samples, uint32_t max_age_ms);
+
+/*
+* Return 0 and the most recent sample, -ENODATA if there is none.
+*/
+int zsw_sensor_history_get_latest(zsw_sensor_history_stream_t stream, zsw_sensor_history_sample_t *sample);
+
+size_t zsw_sensor_history_get_ram_usage(void);
@@ -0,0 +1,192 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "events/accel_event.h"
+#include "events/activity_event.h"
+#include "events/zsw_periodic_event.h"
+#include "sensors/zsw_imu.h"
+#include "sensors/zsw_sensor_hub.h"
+
+LOG_MODULE_REGISTER(zsw_sensor_hub, CONFIG_ZSW_SENSORS_LOG_LEVEL);
+
+#define MS_PER_HOUR (60 * 60 * 1000)
+
+static void zbus_activity_callback(const struct zbus_channel *chan);
+static void zbus_accel_callback(const struct zbus_channel *chan);
+static void zbus_batch_callback(const struct zbus_channel *chan);
+static void handle_step_summary_work(struct k_work *item);
+
+ZBUS_CHAN_DECLARE(accel_data_chan);
+ZBUS_CHAN_DECLARE(periodic_event_slow_chan);
+ZBUS_CHAN_DECLARE(periodic_event_batch_chan);
+
+ZBUS_LISTENER_DEFINE(zsw_sensor_hub_activity_lis, zbus_activity_callback);
+ZBUS_LISTENER_DEFINE(zsw_sensor_hub_accel_lis, zbus_accel_callback);
+ZBUS_LISTENER_DEFINE(zsw_sensor_hub_batch_lis, zbus_batch_callback);
+
+// Runs on the system workqueue like the batch period, so both publish in order.
+K_WORK_DEFINE(step_summary_work, handle_step_summary_work);
+
+// Periodic listeners registered by the sensor modules on periodic_event_slow_chan.
+ZBUS_OBS_DECLARE(zsw_imu_lis, zsw_magnetometer_lis, zsw_pressure_sensor_lis, zsw_light_sensor_lis,
+                 zsw_environment_sensor_lis);
+
+static const struct zbus_observer *const sensor_listeners[] = {
+    &zsw_imu_lis,
+    &zsw_magnetometer_lis,
+    &zsw_pressure_sensor_lis,
+    &zsw_light_sensor_lis,
+    &zsw_environment_sensor_lis,
+};
+
+static bool listener_batched[ARRAY_SIZE(sensor_listeners)];
+static bool is_batching;
+static bool is_publishing_summary;
+static uint32_t last_published_steps;
+static int64_t batch_start_time;
+static uint64_t batch_time_ms;
+static atomic_t batch_wakeups;
+
+bool zsw_sensor_hub_is_batching(void)
+{
+    return is_batching;
+}
+
+uint32_t zsw_sensor_hub_get_wakeups_per_hour(void)
+{
+    uint64_t time_ms = batch_time_ms;
+
+    if (is_batching) {
+        time_ms += k_uptime_get() - batch_start_time;
+    }
+
+    if (time_ms == 0) {
+        return 0;
+    }
+
+    return (uint32_t)(((uint64_t)atomic_get(&batch_wakeups) * MS_PER_HOUR) / time_ms);
+}
+
+static void publish_step_summary(void)
+{
+    uint32_t steps;
+
+    if (zsw_imu_fetch_num_steps(&steps) != 0 || steps == last_published_steps) {
+        return;
+    }
+
+    last_published_steps = steps;
+
+    struct accel_event evt = {
+        .data.type = ZSW_IMU_EVT_TYPE_STEP,
+        .data.data.step.count = steps,
+    };
+
+    is_publishing_summary = true;
+    zbus_chan_pub(&accel_data_chan, &evt, K_MSEC(250));
+    is_publishing_summary = false;
+}
+
+static void handle_step_summary_work(struct k_work *item)
+{
+    publish_step_summary();
+}
+
+static void enter_batch_mode(void)
+{
+    for (int i = 0; i < ARRAY_SIZE(sensor_listeners); i++) {
+        // Sensors that failed to init never registered their listener, leave those alone.
+        if (zsw_periodic_chan_rm_obs(&periodic_event_slow_chan, sensor_listeners[i]) == 0) {
+            zsw_periodic_chan_add_obs(&periodic_event_batch_chan, sensor_listeners[i]);
+            listener_batched[i] = true;
+        }
+    }
+    zsw_periodic_chan_add_obs(&periodic_event_batch_chan, &zsw_sensor_hub_batch_lis);
+
+    // Keep counting steps in the IMU, but don't wake up for every step.
+    zsw_imu_feature_enable(ZSW_IMU_FEATURE_STEP_COUNTER, false);
+    zsw_imu_fetch_num_steps(&last_published_steps);
+
+    batch_start_time = k_uptime_get();
+    is_batching = true;
+}
+
+static void exit_batch_mode(void)
+{
+    uint32_t duration_ms;
+
+    zsw_periodic_chan_rm_obs(&periodic_event_batch_chan, &zsw_sensor_hub_batch_lis);
+    for (int i = 0; i < ARRAY_SIZE(sensor_listeners); i++) {
+        if (listener_batched[i]) {
+            zsw_periodic_chan_rm_obs(&periodic_event_batch_chan, sensor_listeners[i]);
+            zsw_periodic_chan_add_obs(&periodic_event_slow_chan, sensor_listeners[i]);
+            listener_batched[i] = false;
+        }
+    }
+
+    zsw_imu_feature_enable(ZSW_IMU_FEATURE_STEP_COUNTER, true);
+
+    duration_ms = k_uptime_get() - batch_start_time;
+    batch_time_ms += duration_ms;
+    is_batching = false;
+
+    // Make sure the UI shows the steps taken while the display was off. Not
+    // published from here, this runs in the power manager's wake transition.
+    k_work_submit(&step_summary_work);
+
+    LOG_INF("Display off for %us, %u wakeups/h average", duration_ms / 1000,
+            zsw_sensor_hub_get_wakeups_per_hour());
+}
+
+static void zbus_activity_callback(const struct zbus_channel *chan)
+{
+    const struct activity_state_event *event = zbus_chan_const_msg(chan);
+
+    switch (event->state) {
+        case ZSW_ACTIVITY_STATE_ACTIVE:
+            if (is_batching) {
+                exit_batch_mode();
+            }
+            break;
+        case ZSW_ACTIVITY_STATE_INACTIVE:
+        case ZSW_ACTIVITY_STATE_NOT_WORN_STATIONARY:
+            if (!is_batching) {
+                enter_batch_mode();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void zbus_accel_callback(const struct zbus_channel *chan)
+{
+    // Every IMU interrupt delivered while the display is off is one app core wakeup.
+    if (is_batching && !is_publishing_summary) {
+        atomic_inc(&batch_wakeups);
+    }
+}
+
+static void zbus_batch_callback(const struct zbus_channel *chan)
+{
+    atomic_inc(&batch_wakeups);
+    publish_step_summary();
+}
@@ -0,0 +1,39 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+*   While the display is off the sensor hub moves all periodic sensor polling
+*   from the 1s slow tick to a batch tick (CONFIG_ZSW_SENSOR_HUB_BATCH_INTERVAL_S)
+*   and turns the per step IMU interrupt into a step summary published once per batch.
+*   Motion events needed by the power manager are still delivered directly.
+*/
+
+/*
+*   Returns true if sensor sampling currently is batched, i.e. the display is off.
+*/
+bool zsw_sensor_hub_is_batching(void);
+
+/*
+*   Returns the average number of sensor related app core wakeups per hour
+*   measured while the display was off.
+*/
+uint32_t zsw_sensor_hub_get_wakeups_per_hour(void);
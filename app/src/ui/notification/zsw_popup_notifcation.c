@@ -18,6 +18,7 @@
 #include <lvgl.h>
 
 #include "ui/notification/zsw_popup_notifcation.h"
+#include "ui/utils/zsw_ui_text_layout.h"
 
 typedef struct {
     lv_obj_t *panel;
@@ -83,6 +84,8 @@ void zsw_notification_popup_show(char *title, char *body, zsw_notification_src_t
         lv_label_set_long_mode(notif_box.body, LV_LABEL_LONG_DOT);
         lv_label_set_text(notif_box.body, body);
         lv_obj_set_style_text_font(notif_box.body, &lv_font_montserrat_14_full, 0);
+        // Only used once expanded to LV_LABEL_LONG_WRAP.
+        zsw_ui_text_layout_cache_attach(notif_box.body);
 
     }
 
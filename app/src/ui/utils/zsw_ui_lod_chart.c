@@ -0,0 +1,239 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "ui/utils/zsw_ui_lod_chart.h"
+#include "managers/zsw_mem_pressure.h"
+
+// Samples read per read_cb call when paging in history.
+#define PAGE_SAMPLES    32
+
+typedef struct lod_bucket {
+    int32_t min;
+    int32_t max;
+} lod_bucket_t;
+
+typedef struct lod_chart {
+    zsw_ui_lod_chart_read_cb_t read_cb;
+    void *user_data;
+    int32_t y_min;
+    int32_t y_max;
+    lv_color_t color;
+    uint32_t bucket_s;
+    uint32_t end_s; // Right edge of the newest bucket, exclusive.
+    uint16_t num_buckets;
+    uint16_t first; // Ring index of the oldest bucket.
+    zsw_ui_lod_chart_stats_t stats;
+    lod_bucket_t buckets[];
+} lod_chart_t;
+
+static void chart_draw_main_cb(lv_event_t *e);
+static void chart_delete_cb(lv_event_t *e);
+
+static void clear_bucket(lod_bucket_t *bucket)
+{
+    bucket->min = INT32_MAX;
+    bucket->max = INT32_MIN;
+}
+
+static bool is_bucket_empty(const lod_bucket_t *bucket)
+{
+    return bucket->min > bucket->max;
+}
+
+// Left edge of the oldest bucket. Negative while less than a full span has
+// passed since boot, timestamps are uptime based.
+static int64_t window_start_s(const lod_chart_t *lod)
+{
+    return (int64_t)lod->end_s - (int64_t)lod->num_buckets * lod->bucket_s;
+}
+
+static int fold_sample(lod_chart_t *lod, uint32_t timestamp_s, int32_t value)
+{
+    int64_t start_s = window_start_s(lod);
+    lod_bucket_t *bucket;
+    int column;
+
+    if (timestamp_s < start_s || timestamp_s >= lod->end_s) {
+        return -1;
+    }
+
+    column = (timestamp_s - start_s) / lod->bucket_s;
+    bucket = &lod->buckets[(lod->first + column) % lod->num_buckets];
+    bucket->min = MIN(bucket->min, value);
+    bucket->max = MAX(bucket->max, value);
+
+    return column;
+}
+
+static lv_coord_t value_to_y(lod_chart_t *lod, const lv_area_t *coords, int32_t value)
+{
+    int32_t h = lv_area_get_height(coords) - 1;
+
+    value = CLAMP(value, lod->y_min, lod->y_max);
+
+    return coords->y2 - (value - lod->y_min) * h / (lod->y_max - lod->y_min);
+}
+
+lv_obj_t *zsw_ui_lod_chart_create(lv_obj_t *parent, lv_coord_t w, lv_coord_t h, int32_t y_min, int32_t y_max,
+                                  lv_color_t color, zsw_ui_lod_chart_read_cb_t read_cb, void *user_data)
+{
+    size_t size = sizeof(lod_chart_t) + w * sizeof(lod_bucket_t);
+    lod_chart_t *lod;
+    lv_obj_t *chart;
+
+    __ASSERT(y_max > y_min, "Invalid range");
+
+    lod = lv_mem_alloc(size);
+    if (!lod) {
+        zsw_mem_pressure_report_alloc_failure("lod chart", size);
+        return NULL;
+    }
+    memset(lod, 0, size);
+    lod->read_cb = read_cb;
+    lod->user_data = user_data;
+    lod->y_min = y_min;
+    lod->y_max = y_max;
+    lod->color = color;
+    lod->num_buckets = w;
+    lod->bucket_s = 1;
+    lod->stats.ram_bytes = size;
+    for (int i = 0; i < lod->num_buckets; i++) {
+        clear_bucket(&lod->buckets[i]);
+    }
+
+    chart = lv_obj_create(parent);
+    lv_obj_remove_style_all(chart);
+    lv_obj_set_size(chart, w, h);
+    lv_obj_clear_flag(chart, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_user_data(chart, lod);
+    lv_obj_add_event_cb(chart, chart_draw_main_cb, LV_EVENT_DRAW_MAIN, lod);
+    lv_obj_add_event_cb(chart, chart_delete_cb, LV_EVENT_DELETE, lod);
+
+    return chart;
+}
+
+void zsw_ui_lod_chart_set_span(lv_obj_t *chart, uint32_t span_s, uint32_t now_s)
+{
+    lod_chart_t *lod = lv_obj_get_user_data(chart);
+    zsw_ui_lod_chart_sample_t page[PAGE_SAMPLES];
+    uint32_t start = k_cycle_get_32();
+    uint32_t from_s;
+    int num_read;
+
+    lod->bucket_s = MAX(DIV_ROUND_UP(span_s, lod->num_buckets), 1);
+    // Align so a bucket always covers the same time, no matter when the span was set.
+    lod->end_s = (now_s / lod->bucket_s + 1) * lod->bucket_s;
+    lod->first = 0;
+    for (int i = 0; i < lod->num_buckets; i++) {
+        clear_bucket(&lod->buckets[i]);
+    }
+
+    lod->stats.last_page_in_samples = 0;
+    from_s = MAX(window_start_s(lod), 0);
+    do {
+        num_read = lod->read_cb(from_s, page, PAGE_SAMPLES, lod->user_data);
+        for (int i = 0; i < num_read; i++) {
+            fold_sample(lod, page[i].timestamp_s, page[i].value);
+        }
+        lod->stats.last_page_in_samples += num_read;
+        if (num_read > 0) {
+            from_s = page[num_read - 1].timestamp_s + 1;
+        }
+    } while (num_read == PAGE_SAMPLES);
+    lod->stats.last_page_in_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    lv_obj_invalidate(chart);
+}
+
+void zsw_ui_lod_chart_add_sample(lv_obj_t *chart, uint32_t timestamp_s, int32_t value)
+{
+    lod_chart_t *lod = lv_obj_get_user_data(chart);
+    uint32_t num_shift;
+    lv_area_t area;
+    int column;
+
+    if (timestamp_s >= lod->end_s) {
+        num_shift = MIN((timestamp_s - lod->end_s) / lod->bucket_s + 1, lod->num_buckets);
+        for (int i = 0; i < num_shift; i++) {
+            clear_bucket(&lod->buckets[lod->first]);
+            lod->first = (lod->first + 1) % lod->num_buckets;
+        }
+        lod->end_s = (timestamp_s / lod->bucket_s + 1) * lod->bucket_s;
+        fold_sample(lod, timestamp_s, value);
+        lv_obj_invalidate(chart);
+        return;
+    }
+
+    column = fold_sample(lod, timestamp_s, value);
+    if (column >= 0) {
+        lv_obj_get_coords(chart, &area);
+        area.x1 += column;
+        area.x2 = area.x1;
+        lv_obj_invalidate_area(chart, &area);
+    }
+}
+
+void zsw_ui_lod_chart_get_stats(lv_obj_t *chart, zsw_ui_lod_chart_stats_t *stats)
+{
+    lod_chart_t *lod = lv_obj_get_user_data(chart);
+
+    *stats = lod->stats;
+}
+
+static void chart_draw_main_cb(lv_event_t *e)
+{
+    lv_obj_t *chart = lv_event_get_target(e);
+    lod_chart_t *lod = lv_event_get_user_data(e);
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+    uint32_t start = k_cycle_get_32();
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_area_t coords;
+    lv_area_t column_area;
+    lod_bucket_t *bucket;
+    int first_column;
+    int last_column;
+
+    lv_obj_get_coords(chart, &coords);
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.bg_color = lod->color;
+
+    // Only the columns inside the area being redrawn.
+    first_column = MAX(draw_ctx->clip_area->x1 - coords.x1, 0);
+    last_column = MIN(draw_ctx->clip_area->x2 - coords.x1, lod->num_buckets - 1);
+
+    for (int i = first_column; i <= last_column; i++) {
+        bucket = &lod->buckets[(lod->first + i) % lod->num_buckets];
+        if (is_bucket_empty(bucket)) {
+            continue;
+        }
+        column_area.x1 = coords.x1 + i;
+        column_area.x2 = column_area.x1;
+        column_area.y1 = value_to_y(lod, &coords, bucket->max);
+        column_area.y2 = value_to_y(lod, &coords, bucket->min);
+        lv_draw_rect(draw_ctx, &rect_dsc, &column_area);
+    }
+
+    lod->stats.last_draw_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+}
+
+static void chart_delete_cb(lv_event_t *e)
+{
+    lv_mem_free(lv_event_get_user_data(e));
+}
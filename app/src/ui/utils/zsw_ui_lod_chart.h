@@ -0,0 +1,64 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_UI_LOD_CHART_H
+#define __ZSW_UI_LOD_CHART_H
+
+#include <lvgl.h>
+
+typedef struct zsw_ui_lod_chart_sample {
+    uint32_t timestamp_s;
+    int32_t value;
+} zsw_ui_lod_chart_sample_t;
+
+/*
+*   Copy up to max_samples samples with timestamp_s >= from_s into samples,
+*   oldest first. Return the number of samples copied.
+*/
+typedef int (*zsw_ui_lod_chart_read_cb_t)(uint32_t from_s, zsw_ui_lod_chart_sample_t *samples, int max_samples,
+                                          void *user_data);
+
+typedef struct zsw_ui_lod_chart_stats {
+    uint32_t ram_bytes;
+    uint32_t last_draw_us;
+    uint32_t last_page_in_us;
+    uint32_t last_page_in_samples;
+} zsw_ui_lod_chart_stats_t;
+
+/*
+*   Chart for long histories. Samples are folded into one min/max bucket per
+*   pixel column, so RAM and draw time depend on the chart width and not on
+*   the number of samples or the time span shown. History is paged in through
+*   read_cb in small chunks when the span is set.
+*/
+lv_obj_t *zsw_ui_lod_chart_create(lv_obj_t *parent, lv_coord_t w, lv_coord_t h, int32_t y_min, int32_t y_max,
+                                  lv_color_t color, zsw_ui_lod_chart_read_cb_t read_cb, void *user_data);
+
+/*
+*   Show span_s seconds of history ending at now_s, reads all of it again through read_cb.
+*/
+void zsw_ui_lod_chart_set_span(lv_obj_t *chart, uint32_t span_s, uint32_t now_s);
+
+/*
+*   Add a new sample. Only the column it falls in is redrawn, unless the chart
+*   has to scroll.
+*/
+void zsw_ui_lod_chart_add_sample(lv_obj_t *chart, uint32_t timestamp_s, int32_t value);
+
+void zsw_ui_lod_chart_get_stats(lv_obj_t *chart, zsw_ui_lod_chart_stats_t *stats);
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
+#include "ui/utils/zsw_ui_mem.h"
+#include "managers/zsw_mem_pressure.h"
+
+LOG_MODULE_REGISTER(zsw_ui_mem, LOG_LEVEL_INF);
+
+static void release_cached(void);
+static void mem_pressure_shed(zsw_mem_pressure_level_t level);
+
+static zsw_ui_mem_stats_t stats = {
+    .min_largest_free_bytes = UINT32_MAX,
+};
+
+// Cached buffers are rebuilt on the next draw, so give them back first.
+static zsw_mem_pressure_handler_t mem_pressure_handler = {
+    .name = "lvgl_cache",
+    .level = ZSW_MEM_PRESSURE_MODERATE,
+    .priority = 0,
+    .shed = mem_pressure_shed,
+};
+
+static void release_cached(void)
+{
+    lv_mem_buf_free_all();
+    lv_img_cache_invalidate_src(NULL);
+}
+
+static void mem_pressure_shed(zsw_mem_pressure_level_t level)
+{
+    release_cached();
+}
+
+void zsw_ui_mem_release_and_sample(void)
+{
+    lv_mem_monitor_t mon;
+
+    release_cached();
+
+    lv_mem_monitor(&mon);
+    stats.total_bytes = mon.total_size;
+    stats.free_bytes = mon.free_size;
+    stats.largest_free_bytes = mon.free_biggest_size;
+    stats.frag_pct = mon.frag_pct;
+    stats.max_frag_pct = MAX(stats.max_frag_pct, mon.frag_pct);
+    stats.num_samples++;
+
+    if (mon.free_biggest_size < stats.min_largest_free_bytes) {
+        stats.min_largest_free_bytes = mon.free_biggest_size;
+        LOG_INF("New low largest free block: %d bytes (free %d, frag %d%%)", mon.free_biggest_size, mon.free_size,
+                mon.frag_pct);
+    } else {
+        LOG_DBG("Largest free block: %d bytes (free %d, frag %d%%)", mon.free_biggest_size, mon.free_size, mon.frag_pct);
+    }
+}
+
+void zsw_ui_mem_get_stats(zsw_ui_mem_stats_t *out)
+{
+    *out = stats;
+}
+
+static int zsw_ui_mem_init(void)
+{
+    return zsw_mem_pressure_register(&mem_pressure_handler);
+}
+
+SYS_INIT(zsw_ui_mem_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,43 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_UI_MEM_H
+#define __ZSW_UI_MEM_H
+
+#include <lvgl.h>
+
+typedef struct zsw_ui_mem_stats {
+    uint32_t total_bytes;
+    uint32_t free_bytes;
+    uint32_t largest_free_bytes;
+    uint8_t frag_pct; // 100 - largest free block / total free, as reported by LVGL.
+    uint32_t min_largest_free_bytes; // Lowest largest free block seen after an app closed.
+    uint8_t max_frag_pct;
+    uint32_t num_samples;
+} zsw_ui_mem_stats_t;
+
+/*
+*   Release LVGL memory that is only cached, the lv_mem_buf scratch buffers and
+*   cached image decoder data, then sample the pool. Call from the LVGL thread
+*   when a screen has been deleted, so cached buffers allocated while the screen
+*   was open do not stay pinned between later allocations.
+*/
+void zsw_ui_mem_release_and_sample(void);
+
+void zsw_ui_mem_get_stats(zsw_ui_mem_stats_t *stats);
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "ui/utils/zsw_ui_render_stats.h"
+
+LOG_MODULE_REGISTER(zsw_ui_render_stats, LOG_LEVEL_INF);
+
+#define REPORT_INTERVAL_MS  60000
+
+static void draw_begin_cb(lv_event_t *e);
+static void draw_end_cb(lv_event_t *e);
+static void root_delete_cb(lv_event_t *e);
+
+static const char *stats_name;
+static uint32_t pool_free_before;
+static uint32_t pool_used;
+static uint32_t draw_start;
+static uint32_t window_start_ms;
+static uint32_t window_draw_time_us;
+static uint32_t window_num_draws;
+static zsw_ui_render_stats_t last_stats;
+
+void zsw_ui_render_stats_begin(void)
+{
+    lv_mem_monitor_t mon;
+
+    lv_mem_monitor(&mon);
+    pool_free_before = mon.free_size;
+}
+
+void zsw_ui_render_stats_attach(lv_obj_t *root, const char *name)
+{
+    lv_mem_monitor_t mon;
+
+    lv_mem_monitor(&mon);
+    pool_used = pool_free_before > mon.free_size ? pool_free_before - mon.free_size : 0;
+    stats_name = name;
+    window_start_ms = k_uptime_get_32();
+    window_draw_time_us = 0;
+    window_num_draws = 0;
+    memset(&last_stats, 0, sizeof(last_stats));
+    last_stats.name = name;
+    last_stats.pool_used_bytes = pool_used;
+
+    lv_obj_add_event_cb(root, draw_begin_cb, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+    lv_obj_add_event_cb(root, draw_end_cb, LV_EVENT_DRAW_POST_END, NULL);
+    lv_obj_add_event_cb(root, root_delete_cb, LV_EVENT_DELETE, NULL);
+
+    LOG_INF("%s: %d bytes LVGL pool", name, pool_used);
+}
+
+void zsw_ui_render_stats_get(zsw_ui_render_stats_t *stats)
+{
+    *stats = last_stats;
+}
+
+static void draw_begin_cb(lv_event_t *e)
+{
+    draw_start = k_cycle_get_32();
+}
+
+static void draw_end_cb(lv_event_t *e)
+{
+    uint32_t now_ms;
+    uint32_t elapsed_ms;
+
+    // Called once per refreshed area, the whole subtree is drawn in between.
+    window_draw_time_us += k_cyc_to_us_floor32(k_cycle_get_32() - draw_start);
+    window_num_draws++;
+
+    now_ms = k_uptime_get_32();
+    elapsed_ms = now_ms - window_start_ms;
+    if (elapsed_ms < REPORT_INTERVAL_MS) {
+        return;
+    }
+
+    last_stats.render_time_us_per_s = (uint32_t)(((uint64_t)window_draw_time_us * 1000) / elapsed_ms);
+    last_stats.num_draws = window_num_draws;
+    LOG_INF("%s: %d us/s render, %d draws, %d bytes LVGL pool", stats_name, last_stats.render_time_us_per_s,
+            window_num_draws, pool_used);
+
+    window_start_ms = now_ms;
+    window_draw_time_us = 0;
+    window_num_draws = 0;
+}
+
+static void root_delete_cb(lv_event_t *e)
+{
+    stats_name = NULL;
+    pool_used = 0;
+}
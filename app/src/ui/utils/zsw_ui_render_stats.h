@@ -0,0 +1,48 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_UI_RENDER_STATS_H
+#define __ZSW_UI_RENDER_STATS_H
+
+#include <lvgl.h>
+
+typedef struct zsw_ui_render_stats {
+    const char *name; // As passed to zsw_ui_render_stats_attach.
+    uint32_t pool_used_bytes;
+    uint32_t render_time_us_per_s; // Updated every minute, 0 until the first minute has passed.
+    uint32_t num_draws;
+} zsw_ui_render_stats_t;
+
+/*
+*   Snapshot the LVGL pool before a screen is created, call before creating
+*   the objects that are later passed to zsw_ui_render_stats_attach.
+*/
+void zsw_ui_render_stats_begin(void);
+
+/*
+*   Measure LVGL pool used since zsw_ui_render_stats_begin and the time spent
+*   drawing root and all its children. Logs a summary every minute.
+*   Only one root is measured at a time, stats are reset when root is deleted.
+*/
+void zsw_ui_render_stats_attach(lv_obj_t *root, const char *name);
+
+/*
+*   Stats of the last attached root, kept after it is deleted.
+*/
+void zsw_ui_render_stats_get(zsw_ui_render_stats_t *stats);
+
+#endif
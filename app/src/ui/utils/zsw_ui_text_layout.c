@@ -0,0 +1,270 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "ui/utils/zsw_ui_text_layout.h"
+#include "managers/zsw_mem_pressure.h"
+
+LOG_MODULE_REGISTER(zsw_ui_text_layout, LOG_LEVEL_WRN);
+
+#define LINE_STARTS_ALLOC_STEP  8
+
+typedef struct text_layout_cache {
+    bool valid;
+    uint32_t text_hash;
+    uint32_t text_len;
+    const lv_font_t *font;
+    lv_coord_t letter_space;
+    lv_coord_t line_space;
+    lv_coord_t max_width;
+    lv_text_flag_t flag;
+    lv_point_t size;
+    uint32_t num_lines;
+    uint32_t max_lines;
+    uint32_t *line_starts;
+} text_layout_cache_t;
+
+static void label_get_self_size_cb(lv_event_t *e);
+static void label_draw_main_cb(lv_event_t *e);
+static void label_delete_cb(lv_event_t *e);
+
+static zsw_ui_text_layout_stats_t layout_stats;
+
+int zsw_ui_text_layout_cache_attach(lv_obj_t *label)
+{
+    text_layout_cache_t *cache;
+
+    __ASSERT(lv_obj_check_type(label, &lv_label_class), "Text layout cache only supports labels");
+
+    if (zsw_mem_pressure_get_level() != ZSW_MEM_PRESSURE_NONE) {
+        return -ENOMEM;
+    }
+
+    cache = lv_mem_alloc(sizeof(text_layout_cache_t));
+    if (!cache) {
+        zsw_mem_pressure_report_alloc_failure("text layout cache", sizeof(text_layout_cache_t));
+        return -ENOMEM;
+    }
+    memset(cache, 0, sizeof(text_layout_cache_t));
+
+    lv_obj_add_event_cb(label, label_get_self_size_cb, LV_EVENT_GET_SELF_SIZE | LV_EVENT_PREPROCESS, cache);
+    lv_obj_add_event_cb(label, label_draw_main_cb, LV_EVENT_DRAW_MAIN | LV_EVENT_PREPROCESS, cache);
+    lv_obj_add_event_cb(label, label_delete_cb, LV_EVENT_DELETE, cache);
+
+    return 0;
+}
+
+void zsw_ui_text_layout_get_stats(zsw_ui_text_layout_stats_t *stats)
+{
+    memcpy(stats, &layout_stats, sizeof(zsw_ui_text_layout_stats_t));
+    memset(&layout_stats, 0, sizeof(zsw_ui_text_layout_stats_t));
+}
+
+static uint32_t text_hash(const char *text, uint32_t *len)
+{
+    // djb2, cheap compared to measuring every glyph.
+    uint32_t hash = 5381;
+    const char *c = text;
+
+    while (*c != '\0') {
+        hash = ((hash << 5) + hash) + (uint8_t)*c;
+        c++;
+    }
+    *len = c - text;
+
+    return hash;
+}
+
+static bool is_cacheable(lv_obj_t *obj)
+{
+    lv_label_t *label = (lv_label_t *)obj;
+
+    // Content sized labels are measured with an unlimited width, keep LVGL's default handling for those.
+    return label->text && label->long_mode == LV_LABEL_LONG_WRAP && !label->recolor &&
+           lv_obj_get_style_width(obj, LV_PART_MAIN) != LV_SIZE_CONTENT;
+}
+
+static int add_line(text_layout_cache_t *cache, uint32_t line_start)
+{
+    uint32_t *line_starts;
+
+    if (cache->num_lines == cache->max_lines) {
+        line_starts = lv_mem_realloc(cache->line_starts,
+                                     (cache->max_lines + LINE_STARTS_ALLOC_STEP) * sizeof(uint32_t));
+        if (!line_starts) {
+            return -ENOMEM;
+        }
+        cache->line_starts = line_starts;
+        cache->max_lines += LINE_STARTS_ALLOC_STEP;
+    }
+    cache->line_starts[cache->num_lines++] = line_start;
+
+    return 0;
+}
+
+// Same line breaking and size calculation as lv_txt_get_size, but keeps the line starts.
+static int layout_text(text_layout_cache_t *cache, const char *text)
+{
+    uint32_t line_start = 0;
+    uint32_t line_len;
+    lv_coord_t line_width;
+    lv_coord_t line_height = lv_font_get_line_height(cache->font);
+    lv_coord_t max_width = (cache->flag & LV_TEXT_FLAG_EXPAND) ? LV_COORD_MAX : cache->max_width;
+
+    cache->num_lines = 0;
+    cache->size.x = 0;
+
+    while (text[line_start] != '\0') {
+        line_len = _lv_txt_get_next_line(&text[line_start], cache->font, cache->letter_space, max_width, NULL,
+                                         cache->flag);
+        if (line_len == 0 || add_line(cache, line_start) != 0) {
+            return -ENOMEM;
+        }
+        line_width = lv_txt_get_width(&text[line_start], line_len, cache->font, cache->letter_space, cache->flag);
+        cache->size.x = LV_MAX(cache->size.x, line_width);
+        line_start += line_len;
+    }
+
+    if (cache->num_lines == 0) {
+        cache->size.y = line_height;
+        return 0;
+    }
+
+    // A trailing new line makes the text one line taller.
+    if (text[line_start - 1] == '\n' || text[line_start - 1] == '\r') {
+        if (add_line(cache, line_start) != 0) {
+            return -ENOMEM;
+        }
+    }
+    cache->size.y = cache->num_lines * (line_height + cache->line_space) - cache->line_space;
+
+    return 0;
+}
+
+static bool update_layout(lv_obj_t *obj, text_layout_cache_t *cache)
+{
+    lv_label_t *label = (lv_label_t *)obj;
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    lv_coord_t letter_space = lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN);
+    lv_coord_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+    lv_coord_t max_width = lv_obj_get_content_width(obj);
+    lv_text_flag_t flag = label->expand ? LV_TEXT_FLAG_EXPAND : LV_TEXT_FLAG_NONE;
+    uint32_t start;
+    uint32_t len;
+    uint32_t hash = text_hash(label->text, &len);
+
+    if (cache->valid && cache->text_hash == hash && cache->text_len == len && cache->font == font &&
+        cache->letter_space == letter_space && cache->line_space == line_space &&
+        cache->max_width == max_width && cache->flag == flag) {
+        layout_stats.layout_hits++;
+        return true;
+    }
+
+    start = k_cycle_get_32();
+    cache->text_hash = hash;
+    cache->text_len = len;
+    cache->font = font;
+    cache->letter_space = letter_space;
+    cache->line_space = line_space;
+    cache->max_width = max_width;
+    cache->flag = flag;
+    cache->valid = layout_text(cache, label->text) == 0;
+    layout_stats.layout_misses++;
+    layout_stats.layout_time_us += k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    if (!cache->valid) {
+        LOG_WRN("Failed caching text layout, fallback to LVGL");
+    }
+
+    return cache->valid;
+}
+
+static void label_get_self_size_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    text_layout_cache_t *cache = lv_event_get_user_data(e);
+    lv_point_t *self_size = lv_event_get_param(e);
+
+    if (!is_cacheable(obj) || !update_layout(obj, cache)) {
+        return;
+    }
+
+    self_size->x = LV_MAX(self_size->x, cache->size.x);
+    self_size->y = LV_MAX(self_size->y, cache->size.y);
+    lv_event_stop_processing(e);
+}
+
+static void label_draw_main_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    lv_label_t *label = (lv_label_t *)obj;
+    text_layout_cache_t *cache = lv_event_get_user_data(e);
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+    const lv_area_t *clip_area_ori;
+    lv_draw_label_dsc_t label_draw_dsc;
+    lv_area_t txt_coords;
+    lv_area_t txt_clip;
+    lv_coord_t line_pitch;
+    uint32_t first_line = 0;
+    uint32_t start;
+
+    if (!is_cacheable(obj) || !update_layout(obj, cache)) {
+        return;
+    }
+
+    start = k_cycle_get_32();
+
+    // Let the base class draw background, border etc. as the label class would.
+    lv_obj_event_base(&lv_label_class, e);
+    lv_event_stop_processing(e);
+
+    lv_obj_get_content_coords(obj, &txt_coords);
+    if (!_lv_area_intersect(&txt_clip, &txt_coords, draw_ctx->clip_area)) {
+        return;
+    }
+
+    // Skip straight to the first visible line instead of re-breaking all lines above it.
+    line_pitch = lv_font_get_line_height(cache->font) + cache->line_space;
+    if (line_pitch > 0 && txt_clip.y1 > txt_coords.y1) {
+        first_line = (txt_clip.y1 - txt_coords.y1) / line_pitch;
+    }
+    if (first_line >= cache->num_lines) {
+        return;
+    }
+    txt_coords.y1 += first_line * line_pitch;
+
+    lv_draw_label_dsc_init(&label_draw_dsc);
+    label_draw_dsc.flag = cache->flag;
+    lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_draw_dsc);
+
+    clip_area_ori = draw_ctx->clip_area;
+    draw_ctx->clip_area = &txt_clip;
+    lv_draw_label(draw_ctx, &label_draw_dsc, &txt_coords, &label->text[cache->line_starts[first_line]], NULL);
+    draw_ctx->clip_area = clip_area_ori;
+
+    layout_stats.draw_time_us += k_cyc_to_us_floor32(k_cycle_get_32() - start);
+}
+
+static void label_delete_cb(lv_event_t *e)
+{
+    text_layout_cache_t *cache = lv_event_get_user_data(e);
+
+    lv_mem_free(cache->line_starts);
+    lv_mem_free(cache);
+}
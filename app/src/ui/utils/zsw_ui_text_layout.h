@@ -0,0 +1,48 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_UI_TEXT_LAYOUT_H
+#define __ZSW_UI_TEXT_LAYOUT_H
+
+#include <lvgl.h>
+
+typedef struct zsw_ui_text_layout_stats {
+    uint32_t layout_hits;
+    uint32_t layout_misses;
+    uint32_t layout_time_us;
+    uint32_t draw_time_us;
+} zsw_ui_text_layout_stats_t;
+
+/*
+*   Cache the line breaks and size of a wrapped label (LV_LABEL_LONG_WRAP).
+*   LVGL measures every glyph of a label each time its parent is laid out
+*   (which happens on every scroll step in flex lists with translated children)
+*   and re-breaks all lines above the visible area on every draw.
+*   With the cache the layout is only redone when the text, font, spacing or
+*   width changes, and drawing starts directly at the first visible line.
+*   Labels in other long modes or with recolor enabled fall back to plain LVGL.
+*   The cache is freed together with the label. No cache is attached while
+*   there is memory pressure, the label then works as a plain LVGL label.
+*/
+int zsw_ui_text_layout_cache_attach(lv_obj_t *label);
+
+/*
+*   Accumulated cost of all cached labels since last call, then reset.
+*/
+void zsw_ui_text_layout_get_stats(zsw_ui_text_layout_stats_t *stats);
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include "ui/utils/zsw_ui_transition.h"
+#include "managers/zsw_perf_profile.h"
+#include "managers/zsw_mem_pressure.h"
+
+LOG_MODULE_REGISTER(zsw_ui_transition, LOG_LEVEL_WRN);
+
+#ifdef CONFIG_ZSW_UI_SNAPSHOT_TRANSITIONS
+
+#define TRANSITION_TIME_MS  250
+// The slowest screen change, app manager closing into the watchface, creates
+// the new screen ~100 ms after the capture. Anything older than this was
+// captured for a screen change that never happened.
+#define SNAPSHOT_MAX_AGE_MS 1000
+
+static void transition_finish(void);
+
+static lv_img_dsc_t snapshot_dsc;
+static void *snapshot_buf;
+static lv_obj_t *snapshot_img;
+static zsw_ui_transition_t pending_transition;
+static uint32_t snapshot_time;
+static uint32_t transition_start_time;
+static uint32_t transition_num_frames;
+
+int zsw_ui_transition_capture(zsw_ui_transition_t transition)
+{
+    lv_obj_t *scr = lv_scr_act();
+    uint32_t buf_size;
+
+    if (!zsw_perf_profile_get_policy()->animations) {
+        return -ENOTSUP;
+    }
+
+    // Not worth pushing other allocations into failing for an animation.
+    if (zsw_mem_pressure_get_level() != ZSW_MEM_PRESSURE_NONE) {
+        return -ENOMEM;
+    }
+
+    if (snapshot_buf && !snapshot_img && lv_tick_elaps(snapshot_time) <= SNAPSHOT_MAX_AGE_MS) {
+        // Already captured, but not yet animated.
+        return 0;
+    }
+
+    transition_finish();
+
+    buf_size = lv_snapshot_buf_size_needed(scr, LV_IMG_CF_TRUE_COLOR);
+    if (buf_size == 0) {
+        return -EINVAL;
+    }
+
+    snapshot_buf = k_malloc(buf_size);
+    if (!snapshot_buf) {
+        zsw_mem_pressure_report_alloc_failure("transition snapshot", buf_size);
+        return -ENOMEM;
+    }
+
+    if (lv_snapshot_take_to_buf(scr, LV_IMG_CF_TRUE_COLOR, &snapshot_dsc, snapshot_buf, buf_size) != LV_RES_OK) {
+        k_free(snapshot_buf);
+        snapshot_buf = NULL;
+        return -EIO;
+    }
+
+    pending_transition = transition;
+    snapshot_time = lv_tick_get();
+
+    return 0;
+}
+
+void zsw_ui_transition_cancel(void)
+{
+    if (!snapshot_img) {
+        transition_finish();
+    }
+}
+
+static void anim_x_cb(void *var, int32_t v)
+{
+    transition_num_frames++;
+    lv_obj_set_x(var, v);
+}
+
+static void anim_opa_cb(void *var, int32_t v)
+{
+    transition_num_frames++;
+    // img_opa is applied when drawing the image, unlike opa which needs an extra layer buffer.
+    lv_obj_set_style_img_opa(var, v, LV_PART_MAIN);
+}
+
+static void anim_ready_cb(lv_anim_t *anim)
+{
+    uint32_t duration = lv_tick_elaps(transition_start_time);
+
+    LOG_DBG("Transition done: %d frames in %dms", transition_num_frames, duration);
+    transition_finish();
+}
+
+void zsw_ui_transition_start(void)
+{
+    lv_anim_t anim;
+    lv_coord_t hor_res = lv_disp_get_hor_res(NULL);
+
+    if (!snapshot_buf || snapshot_img) {
+        return;
+    }
+
+    if (lv_tick_elaps(snapshot_time) > SNAPSHOT_MAX_AGE_MS) {
+        LOG_DBG("Dropping stale snapshot");
+        transition_finish();
+        return;
+    }
+
+    // Layer top is drawn above the active screen and is not clickable.
+    snapshot_img = lv_img_create(lv_layer_top());
+    lv_img_set_src(snapshot_img, &snapshot_dsc);
+    lv_obj_set_pos(snapshot_img, 0, 0);
+
+    lv_anim_init(&anim);
+    lv_anim_set_var(&anim, snapshot_img);
+    lv_anim_set_time(&anim, TRANSITION_TIME_MS);
+    lv_anim_set_path_cb(&anim, lv_anim_path_ease_out);
+    lv_anim_set_ready_cb(&anim, anim_ready_cb);
+
+    switch (pending_transition) {
+        case ZSW_UI_TRANSITION_SLIDE_LEFT:
+            lv_anim_set_exec_cb(&anim, anim_x_cb);
+            lv_anim_set_values(&anim, 0, -hor_res);
+            break;
+        case ZSW_UI_TRANSITION_SLIDE_RIGHT:
+            lv_anim_set_exec_cb(&anim, anim_x_cb);
+            lv_anim_set_values(&anim, 0, hor_res);
+            break;
+        case ZSW_UI_TRANSITION_FADE:
+            lv_anim_set_exec_cb(&anim, anim_opa_cb);
+            lv_anim_set_values(&anim, LV_OPA_COVER, LV_OPA_TRANSP);
+            break;
+    }
+
+    transition_num_frames = 0;
+    transition_start_time = lv_tick_get();
+    lv_anim_start(&anim);
+}
+
+static void transition_finish(void)
+{
+    if (snapshot_img) {
+        lv_anim_del(snapshot_img, NULL);
+        lv_obj_del(snapshot_img);
+        snapshot_img = NULL;
+    }
+
+    if (snapshot_buf) {
+        k_free(snapshot_buf);
+        snapshot_buf = NULL;
+    }
+}
+#else
+int zsw_ui_transition_capture(zsw_ui_transition_t transition)
+{
+    return -ENOTSUP;
+}
+
+void zsw_ui_transition_start(void)
+{
+}
+
+void zsw_ui_transition_cancel(void)
+{
+}
+#endif
@@ -0,0 +1,53 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZSW_UI_TRANSITION_H
+#define __ZSW_UI_TRANSITION_H
+
+typedef enum zsw_ui_transition_t {
+    ZSW_UI_TRANSITION_SLIDE_LEFT,
+    ZSW_UI_TRANSITION_SLIDE_RIGHT,
+    ZSW_UI_TRANSITION_FADE,
+} zsw_ui_transition_t;
+
+/*
+*   Render the active screen once into a snapshot image before it is torn down.
+*   If a snapshot taken less than a second ago is waiting to be animated it is
+*   kept, so the first capture in a chain of screen changes is the one that animates.
+*
+*   Return 0 on success, -ENOMEM if there is not enough heap for the snapshot
+*   or there is memory pressure,
+*   -ENOTSUP if CONFIG_ZSW_UI_SNAPSHOT_TRANSITIONS is not enabled.
+*/
+int zsw_ui_transition_capture(zsw_ui_transition_t transition);
+
+/*
+*   Animate the captured snapshot on top of the new screen, call when the
+*   incoming screen has been created. Only the new screen is a live object
+*   tree, the outgoing one is drawn as a single image.
+*   Does nothing if no snapshot was captured, a snapshot older than a second
+*   is freed without being animated.
+*/
+void zsw_ui_transition_start(void);
+
+/*
+*   Free a captured snapshot that will not be animated, call on paths that
+*   capture but end up not changing screen.
+*/
+void zsw_ui_transition_cancel(void);
+
+#endif
@@ -18,6 +18,7 @@
 #include <lvgl.h>
 
 #include "../utils/zsw_ui_utils.h"
+#include "../utils/zsw_ui_render_stats.h"
 #include "../../applications/watchface/watchface_app.h"
 
 #ifdef __ZEPHYR__
@@ -78,6 +79,7 @@ static watchface_app_evt_listener ui_evt_cb;
 static void watchface_show(watchface_app_evt_listener evt_cb)
 {
     ui_evt_cb = evt_cb;
+    zsw_ui_render_stats_begin();
     lv_obj_clear_flag(lv_scr_act(), LV_OBJ_FLAG_SCROLLABLE);
     root_page = lv_obj_create(lv_scr_act());
     watchface_ui_invalidate_cached();
@@ -448,6 +450,8 @@ static void watchface_show(watchface_app_evt_listener evt_cb)
     // Listeners
     lv_obj_add_event_cb(ui_battery_arc, arc_event_pressed, LV_EVENT_CLICKED, NULL);
     lv_obj_add_event_cb(ui_step_arc, arc_event_pressed, LV_EVENT_CLICKED, NULL);
+
+    zsw_ui_render_stats_attach(root_page, "digital watchface");
 }
 
 static void watchface_remove(void)
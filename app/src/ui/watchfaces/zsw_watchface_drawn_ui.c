@@ -0,0 +1,580 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <lvgl.h>
+
+#include "../utils/zsw_ui_utils.h"
+#include "../utils/zsw_ui_render_stats.h"
+#include "../../applications/watchface/watchface_app.h"
+
+#ifdef __ZEPHYR__
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(watchface_drawn, LOG_LEVEL_WRN);
+#endif
+
+/*
+* Same look as the digital watchface, but instead of one LVGL object per
+* arc, label and icon everything is drawn by a single object from the
+* state below. A setter only invalidates the area of the element it changed.
+*/
+
+#define WATCHFACE_SIZE      240
+#define ARC_BG_COLOR        lv_color_hex(0x353535)
+#define TIME_PAD            5
+#define TEXT_BUF_LEN        8
+
+typedef enum drawn_element_t {
+    ELEMENT_PRESSURE,
+    ELEMENT_HUMIDITY,
+    ELEMENT_TIME,
+    ELEMENT_SECONDS,
+    ELEMENT_BATTERY,
+    ELEMENT_STEPS,
+    ELEMENT_DAY,
+    ELEMENT_DATE,
+    ELEMENT_STATUS,
+    ELEMENT_WEATHER,
+    ELEMENT_NUM,
+} drawn_element_t;
+
+typedef struct drawn_state_t {
+    int8_t hour;
+    int8_t minute;
+    int8_t second;
+    int8_t day_of_week;
+    int8_t date;
+    int8_t battery_percent;
+    int16_t battery_value;
+    int32_t steps;
+    int16_t num_notifications;
+    bool ble_connected;
+    int8_t weather_temperature;
+    int weather_code;
+    int16_t temperature;
+    int16_t humidity;
+    int16_t pressure;
+} drawn_state_t;
+
+static void watchface_ui_invalidate_cached(void);
+static void draw_event_cb(lv_event_t *e);
+static void click_event_cb(lv_event_t *e);
+
+LV_IMG_DECLARE(ui_img_pressure_png);    // assets/pressure.png
+LV_IMG_DECLARE(ui_img_temperatures_png);    // assets/temperatures.png
+LV_IMG_DECLARE(ui_img_charging_png);    // assets/charging.png
+LV_IMG_DECLARE(ui_img_running_png);    // assets/running.png
+LV_IMG_DECLARE(ui_img_chat_png);    // assets/chat.png
+LV_IMG_DECLARE(ui_img_bluetooth_png);    // assets/bluetooth.png
+
+LV_FONT_DECLARE(ui_font_aliean_47);
+LV_FONT_DECLARE(ui_font_aliean_25);
+
+static const char *days[] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
+
+static lv_obj_t *root_page = NULL;
+static watchface_app_evt_listener ui_evt_cb;
+static drawn_state_t state;
+// Element areas relative to the top left corner of root_page
+static lv_area_t element_areas[ELEMENT_NUM];
+static lv_coord_t time_digit_width;
+static lv_coord_t time_colon_width;
+static lv_coord_t sec_digit_width;
+
+static void area_set_centered(lv_area_t *area, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h)
+{
+    area->x1 = WATCHFACE_SIZE / 2 + x - w / 2;
+    area->y1 = WATCHFACE_SIZE / 2 + y - h / 2;
+    area->x2 = area->x1 + w - 1;
+    area->y2 = area->y1 + h - 1;
+}
+
+static void area_to_abs(lv_obj_t *obj, const lv_area_t *rel, lv_area_t *abs)
+{
+    lv_area_copy(abs, rel);
+    lv_area_move(abs, obj->coords.x1, obj->coords.y1);
+}
+
+static lv_coord_t font_max_digit_width(const lv_font_t *font)
+{
+    lv_coord_t max = 0;
+
+    for (char c = '0'; c <= '9'; c++) {
+        max = LV_MAX(max, lv_font_get_glyph_width(font, c, '\0'));
+    }
+
+    return max;
+}
+
+static void join_area(lv_area_t *area, const lv_area_t *other)
+{
+    lv_area_t joined;
+
+    _lv_area_join(&joined, area, other);
+    lv_area_copy(area, &joined);
+}
+
+static void calculate_element_areas(void)
+{
+    lv_area_t area;
+    lv_coord_t time_width;
+    lv_coord_t x;
+    lv_coord_t y;
+
+    // Environment arcs run along the edge of the screen, same angles as the digital watchface.
+    lv_draw_arc_get_area(WATCHFACE_SIZE / 2, WATCHFACE_SIZE / 2, WATCHFACE_SIZE / 2, 196, 246, 5, false,
+                         &element_areas[ELEMENT_PRESSURE]);
+    area_set_centered(&area, -70, -68, ui_img_pressure_png.header.w, ui_img_pressure_png.header.h);
+    join_area(&element_areas[ELEMENT_PRESSURE], &area);
+
+    lv_draw_arc_get_area(WATCHFACE_SIZE / 2, WATCHFACE_SIZE / 2, WATCHFACE_SIZE / 2, 291, 346, 5, false,
+                         &element_areas[ELEMENT_HUMIDITY]);
+    area_set_centered(&area, 70, -68, ui_img_temperatures_png.header.w, ui_img_temperatures_png.header.h);
+    join_area(&element_areas[ELEMENT_HUMIDITY], &area);
+    area_set_centered(&area, 86, -51, 40, lv_font_montserrat_12.line_height);
+    join_area(&element_areas[ELEMENT_HUMIDITY], &area);
+
+    // Fixed width digit cells so that changing digits never moves other elements.
+    time_digit_width = font_max_digit_width(&ui_font_aliean_47);
+    time_colon_width = lv_font_get_glyph_width(&ui_font_aliean_47, ':', '\0');
+    sec_digit_width = font_max_digit_width(&ui_font_aliean_25);
+    time_width = 4 * time_digit_width + time_colon_width + 2 * sec_digit_width + 3 * TIME_PAD;
+    x = (WATCHFACE_SIZE - time_width) / 2;
+    y = (WATCHFACE_SIZE - ui_font_aliean_47.line_height) / 2;
+    lv_area_set(&element_areas[ELEMENT_TIME], x, y, x + 4 * time_digit_width + time_colon_width + 2 * TIME_PAD - 1,
+                y + ui_font_aliean_47.line_height - 1);
+    x = element_areas[ELEMENT_TIME].x2 + 1 + TIME_PAD;
+    lv_area_set(&element_areas[ELEMENT_SECONDS], x, y, x + 2 * sec_digit_width - 1,
+                y + ui_font_aliean_25.line_height - 1);
+
+    area_set_centered(&element_areas[ELEMENT_BATTERY], 52, 67, 50, 50);
+    area_set_centered(&area, 52, 87, 40, lv_font_montserrat_10.line_height);
+    join_area(&element_areas[ELEMENT_BATTERY], &area);
+
+    area_set_centered(&element_areas[ELEMENT_STEPS], -52, 67, 50, 50);
+    area_set_centered(&area, -52, 87, 40, lv_font_montserrat_10.line_height);
+    join_area(&element_areas[ELEMENT_STEPS], &area);
+
+    area_set_centered(&element_areas[ELEMENT_DAY], 0, -92, 60, lv_font_montserrat_16.line_height);
+    area_set_centered(&element_areas[ELEMENT_DATE], 0, -73, 40, lv_font_montserrat_20.line_height);
+    area_set_centered(&element_areas[ELEMENT_STATUS], 0, -50,
+                      ui_img_chat_png.header.w + ui_img_bluetooth_png.header.w + TIME_PAD,
+                      LV_MAX(ui_img_chat_png.header.h, ui_img_bluetooth_png.header.h));
+    area_set_centered(&element_areas[ELEMENT_WEATHER], 0, 95, 70, 32);
+}
+
+static void invalidate_element(drawn_element_t element)
+{
+    lv_area_t area;
+
+    area_to_abs(root_page, &element_areas[element], &area);
+    lv_obj_invalidate_area(root_page, &area);
+}
+
+static void watchface_show(watchface_app_evt_listener evt_cb)
+{
+    ui_evt_cb = evt_cb;
+    zsw_ui_render_stats_begin();
+    lv_obj_clear_flag(lv_scr_act(), LV_OBJ_FLAG_SCROLLABLE);
+    root_page = lv_obj_create(lv_scr_act());
+    watchface_ui_invalidate_cached();
+
+    lv_obj_clear_flag(root_page, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scrollbar_mode(root_page, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_style_bg_opa(root_page, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_width(root_page, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(root_page, 0, LV_PART_MAIN);
+    lv_obj_set_size(root_page, WATCHFACE_SIZE, WATCHFACE_SIZE);
+    lv_obj_align(root_page, LV_ALIGN_CENTER, 0, 0);
+
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_hex(0x331c2a), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_img_src(root_page, global_watchface_bg_img, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    calculate_element_areas();
+    lv_obj_add_event_cb(root_page, draw_event_cb, LV_EVENT_DRAW_MAIN, NULL);
+    lv_obj_add_event_cb(root_page, click_event_cb, LV_EVENT_CLICKED, NULL);
+
+    zsw_ui_render_stats_attach(root_page, "drawn watchface");
+}
+
+static void watchface_remove(void)
+{
+    lv_obj_del(root_page);
+    root_page = NULL;
+}
+
+static void draw_text(lv_draw_ctx_t *draw_ctx, const lv_area_t *area, const char *text, const lv_font_t *font,
+                      lv_color_t color)
+{
+    lv_draw_label_dsc_t dsc;
+
+    lv_draw_label_dsc_init(&dsc);
+    dsc.font = font;
+    dsc.color = color;
+    dsc.align = LV_TEXT_ALIGN_CENTER;
+    lv_draw_label(draw_ctx, &dsc, area, text, NULL);
+}
+
+static void draw_text_centered(lv_draw_ctx_t *draw_ctx, const lv_point_t *origin, lv_coord_t x, lv_coord_t y,
+                               lv_coord_t w, const char *text, const lv_font_t *font, lv_color_t color)
+{
+    lv_area_t area;
+
+    area_set_centered(&area, x, y, w, font->line_height);
+    lv_area_move(&area, origin->x, origin->y);
+    draw_text(draw_ctx, &area, text, font, color);
+}
+
+static void draw_icon(lv_draw_ctx_t *draw_ctx, const lv_point_t *origin, lv_coord_t x, lv_coord_t y,
+                      const lv_img_dsc_t *img, lv_color_t recolor)
+{
+    lv_draw_img_dsc_t dsc;
+    lv_area_t area;
+
+    lv_draw_img_dsc_init(&dsc);
+    dsc.recolor = recolor;
+    dsc.recolor_opa = LV_OPA_COVER;
+    area_set_centered(&area, x, y, img->header.w, img->header.h);
+    lv_area_move(&area, origin->x, origin->y);
+    lv_draw_img(draw_ctx, &dsc, &area, img);
+}
+
+static void draw_arc(lv_draw_ctx_t *draw_ctx, const lv_point_t *center, uint16_t radius, lv_coord_t width,
+                     uint16_t bg_start, uint16_t bg_end, uint16_t start, uint16_t end, lv_color_t color)
+{
+    lv_draw_arc_dsc_t dsc;
+
+    lv_draw_arc_dsc_init(&dsc);
+    dsc.width = width;
+    dsc.color = ARC_BG_COLOR;
+    lv_draw_arc(draw_ctx, &dsc, center, radius, bg_start, bg_end);
+
+    if (start != end) {
+        dsc.color = color;
+        lv_draw_arc(draw_ctx, &dsc, center, radius, start, end);
+    }
+}
+
+static uint16_t arc_value_angle(uint16_t start, uint16_t span, int32_t value, int32_t min, int32_t max)
+{
+    value = LV_CLAMP(min, value, max);
+
+    return (start + (span * (value - min)) / (max - min)) % 360;
+}
+
+static void draw_element(lv_draw_ctx_t *draw_ctx, const lv_point_t *origin, drawn_element_t element)
+{
+    char buf[TEXT_BUF_LEN];
+    lv_point_t center;
+    lv_area_t area;
+    lv_color_t icon_color;
+    const lv_img_dsc_t *icon;
+
+    switch (element) {
+        case ELEMENT_PRESSURE:
+            center.x = origin->x + WATCHFACE_SIZE / 2;
+            center.y = origin->y + WATCHFACE_SIZE / 2;
+            draw_arc(draw_ctx, &center, WATCHFACE_SIZE / 2, 5, 196, 246, 196,
+                     arc_value_angle(196, 50, state.pressure, 950, 1050), lv_color_hex(0x4AC73F));
+            draw_icon(draw_ctx, origin, -70, -68, &ui_img_pressure_png, lv_color_hex(0xFFFFFF));
+            break;
+        case ELEMENT_HUMIDITY:
+            center.x = origin->x + WATCHFACE_SIZE / 2;
+            center.y = origin->y + WATCHFACE_SIZE / 2;
+            // Filled from the end of the arc, like LV_ARC_MODE_REVERSE in the digital watchface.
+            draw_arc(draw_ctx, &center, WATCHFACE_SIZE / 2, 5, 291, 346,
+                     arc_value_angle(291, 55, 100 - state.humidity, 0, 100), 346, lv_color_hex(0x60AEF7));
+            draw_icon(draw_ctx, origin, 70, -68, &ui_img_temperatures_png, lv_color_hex(0xDADADA));
+            if (state.temperature == INT16_MIN) {
+                snprintf(buf, sizeof(buf), "-°");
+            } else {
+                snprintf(buf, sizeof(buf), "%d°", state.temperature);
+            }
+            draw_text_centered(draw_ctx, origin, 86, -51, 40, buf, &lv_font_montserrat_12, lv_color_hex(0xFFFFFF));
+            break;
+        case ELEMENT_TIME:
+            if (state.hour < 0) {
+                break;
+            }
+            area_to_abs(root_page, &element_areas[ELEMENT_TIME], &area);
+            area.x2 = area.x1 + 2 * time_digit_width - 1;
+            snprintf(buf, sizeof(buf), "%02d", state.hour);
+            draw_text(draw_ctx, &area, buf, &ui_font_aliean_47, lv_color_hex(0xFFFFFF));
+            lv_area_move(&area, 2 * time_digit_width + TIME_PAD, 0);
+            area.x2 = area.x1 + time_colon_width - 1;
+            draw_text(draw_ctx, &area, ":", &ui_font_aliean_47, lv_color_hex(0xFF8600));
+            area.x1 = area.x2 + 1 + TIME_PAD;
+            area.x2 = area.x1 + 2 * time_digit_width - 1;
+            snprintf(buf, sizeof(buf), "%02d", state.minute);
+            draw_text(draw_ctx, &area, buf, &ui_font_aliean_47, lv_color_hex(0xFFFFFF));
+            break;
+        case ELEMENT_SECONDS:
+            if (state.second < 0) {
+                break;
+            }
+            area_to_abs(root_page, &element_areas[ELEMENT_SECONDS], &area);
+            snprintf(buf, sizeof(buf), "%02d", state.second);
+            draw_text(draw_ctx, &area, buf, &ui_font_aliean_25, lv_color_hex(0xFF8600));
+            break;
+        case ELEMENT_BATTERY:
+            center.x = origin->x + WATCHFACE_SIZE / 2 + 52;
+            center.y = origin->y + WATCHFACE_SIZE / 2 + 67;
+            draw_arc(draw_ctx, &center, 25, 3, 135, 45, 135, arc_value_angle(135, 270, state.battery_percent, 0, 100),
+                     lv_color_hex(0xFFB140));
+            draw_icon(draw_ctx, origin, 52, 67, &ui_img_charging_png, lv_color_hex(0xFFFFFF));
+            snprintf(buf, sizeof(buf), "%d", state.battery_value);
+            draw_text_centered(draw_ctx, origin, 52, 87, 40, buf, &lv_font_montserrat_10, lv_color_hex(0xFFFFFF));
+            break;
+        case ELEMENT_STEPS:
+            center.x = origin->x + WATCHFACE_SIZE / 2 - 52;
+            center.y = origin->y + WATCHFACE_SIZE / 2 + 67;
+            draw_arc(draw_ctx, &center, 25, 3, 135, 45, 135, arc_value_angle(135, 270, state.steps, 0, 10000),
+                     lv_color_hex(0x9D3BE0));
+            draw_icon(draw_ctx, origin, -52, 67, &ui_img_running_png, lv_color_hex(0xFFFFFF));
+            if (state.steps >= 0) {
+                snprintf(buf, sizeof(buf), "%d", state.steps);
+                draw_text_centered(draw_ctx, origin, -52, 87, 40, buf, &lv_font_montserrat_10, lv_color_hex(0xFFFFFF));
+            }
+            break;
+        case ELEMENT_DAY:
+            if (state.day_of_week >= 0) {
+                draw_text_centered(draw_ctx, origin, 0, -92, 60, days[state.day_of_week], &lv_font_montserrat_16,
+                                   lv_color_hex(0xA3A1A1));
+            }
+            break;
+        case ELEMENT_DATE:
+            if (state.date >= 0) {
+                snprintf(buf, sizeof(buf), "%d", state.date);
+                draw_text_centered(draw_ctx, origin, 0, -73, 40, buf, &lv_font_montserrat_20, lv_color_hex(0xFF8600));
+            }
+            break;
+        case ELEMENT_STATUS:
+            if (state.num_notifications > 0 && state.ble_connected) {
+                draw_icon(draw_ctx, origin, -(ui_img_bluetooth_png.header.w + TIME_PAD) / 2, -50, &ui_img_chat_png,
+                          lv_color_hex(0xFFFFFF));
+                snprintf(buf, sizeof(buf), "%d", state.num_notifications);
+                draw_text_centered(draw_ctx, origin, -(ui_img_bluetooth_png.header.w + TIME_PAD) / 2 - 3, -53, 20, buf,
+                                   &lv_font_montserrat_12, lv_color_hex(0xFFFFFF));
+                draw_icon(draw_ctx, origin, (ui_img_chat_png.header.w + TIME_PAD) / 2, -50, &ui_img_bluetooth_png,
+                          lv_color_hex(0x0082FC));
+            } else if (state.num_notifications > 0) {
+                draw_icon(draw_ctx, origin, 0, -50, &ui_img_chat_png, lv_color_hex(0xFFFFFF));
+                snprintf(buf, sizeof(buf), "%d", state.num_notifications);
+                draw_text_centered(draw_ctx, origin, -3, -53, 20, buf, &lv_font_montserrat_12, lv_color_hex(0xFFFFFF));
+            } else if (state.ble_connected) {
+                draw_icon(draw_ctx, origin, 0, -50, &ui_img_bluetooth_png, lv_color_hex(0x0082FC));
+            }
+            break;
+        case ELEMENT_WEATHER:
+            icon = zsw_ui_utils_icon_from_weather_code(state.weather_code, &icon_color);
+            draw_icon(draw_ctx, origin, -12, 95, icon, icon_color);
+            if (state.weather_temperature == INT8_MIN) {
+                snprintf(buf, sizeof(buf), "-°");
+            } else {
+                snprintf(buf, sizeof(buf), "%d°", state.weather_temperature);
+            }
+            draw_text_centered(draw_ctx, origin, 12, 95, 40, buf, &lv_font_montserrat_14, lv_color_hex(0xFFFFFF));
+            break;
+        default:
+            break;
+    }
+}
+
+static void draw_event_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+    lv_point_t origin = { obj->coords.x1, obj->coords.y1 };
+    lv_area_t area;
+
+    // Only draw elements overlapping the area LVGL is currently refreshing.
+    for (int i = 0; i < ELEMENT_NUM; i++) {
+        area_to_abs(obj, &element_areas[i], &area);
+        if (_lv_area_is_on(&area, draw_ctx->clip_area)) {
+            draw_element(draw_ctx, &origin, i);
+        }
+    }
+}
+
+static void click_event_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    lv_indev_t *indev = lv_indev_get_act();
+    lv_point_t point;
+    lv_area_t area;
+
+    if (!indev || !ui_evt_cb) {
+        return;
+    }
+
+    lv_indev_get_point(indev, &point);
+    area_to_abs(obj, &element_areas[ELEMENT_BATTERY], &area);
+    if (_lv_area_is_point_on(&area, &point, 0)) {
+        ui_evt_cb(WATCHFACE_APP_EVT_CLICK_BATT);
+        return;
+    }
+    area_to_abs(obj, &element_areas[ELEMENT_STEPS], &area);
+    if (_lv_area_is_point_on(&area, &point, 0)) {
+        ui_evt_cb(WATCHFACE_APP_EVT_CLICK_STEP);
+    }
+}
+
+static void watchface_set_battery_percent(int32_t percent, int32_t value)
+{
+    if (!root_page || (state.battery_percent == percent && state.battery_value == value)) {
+        return;
+    }
+    state.battery_percent = percent;
+    state.battery_value = value;
+    invalidate_element(ELEMENT_BATTERY);
+}
+
+static void watchface_set_hrm(int32_t value)
+{
+}
+
+static void watchface_set_step(int32_t value)
+{
+    if (!root_page || state.steps == value) {
+        return;
+    }
+    state.steps = value;
+    invalidate_element(ELEMENT_STEPS);
+}
+
+static void watchface_set_time(int32_t hour, int32_t minute, int32_t second)
+{
+    if (!root_page) {
+        return;
+    }
+    if (state.hour != hour || state.minute != minute) {
+        state.hour = hour;
+        state.minute = minute;
+        invalidate_element(ELEMENT_TIME);
+    }
+    if (state.second != second) {
+        state.second = second;
+        invalidate_element(ELEMENT_SECONDS);
+    }
+}
+
+static void watchface_set_num_notifcations(int32_t value)
+{
+    if (!root_page || state.num_notifications == value) {
+        return;
+    }
+    state.num_notifications = value;
+    invalidate_element(ELEMENT_STATUS);
+}
+
+static void watchface_set_ble_connected(bool connected)
+{
+    if (!root_page || state.ble_connected == connected) {
+        return;
+    }
+    state.ble_connected = connected;
+    invalidate_element(ELEMENT_STATUS);
+}
+
+static void watchface_set_weather(int8_t temperature, int weather_code)
+{
+    if (!root_page || (state.weather_temperature == temperature && state.weather_code == weather_code)) {
+        return;
+    }
+    state.weather_temperature = temperature;
+    state.weather_code = weather_code;
+    invalidate_element(ELEMENT_WEATHER);
+}
+
+static void watchface_set_date(int day_of_week, int date)
+{
+    if (!root_page) {
+        return;
+    }
+    if (state.day_of_week != day_of_week) {
+        state.day_of_week = day_of_week % (sizeof(days) / sizeof(days[0]));
+        invalidate_element(ELEMENT_DAY);
+    }
+    if (state.date != date) {
+        state.date = date;
+        invalidate_element(ELEMENT_DATE);
+    }
+}
+
+static void watchface_set_watch_env_sensors(int temperature, int humidity, int pressure)
+{
+    if (!root_page) {
+        return;
+    }
+    if (state.pressure != pressure / 100) {
+        state.pressure = pressure / 100;
+        invalidate_element(ELEMENT_PRESSURE);
+    }
+    if (state.temperature != temperature || state.humidity != humidity) {
+        state.temperature = temperature;
+        state.humidity = humidity;
+        invalidate_element(ELEMENT_HUMIDITY);
+    }
+}
+
+static void watchface_ui_invalidate_cached(void)
+{
+    state = (drawn_state_t) {
+        .hour = -1,
+        .minute = -1,
+        .second = -1,
+        .day_of_week = -1,
+        .date = -1,
+        .battery_percent = 0,
+        .battery_value = 0,
+        .steps = -1,
+        .num_notifications = 0,
+        .ble_connected = false,
+        .weather_temperature = INT8_MIN,
+        .weather_code = 802,
+        .temperature = INT16_MIN,
+        .humidity = 0,
+        .pressure = 950,
+    };
+    if (root_page) {
+        lv_obj_invalidate(root_page);
+    }
+}
+
+static watchface_ui_api_t ui_api = {
+    .show = watchface_show,
+    .remove = watchface_remove,
+    .set_battery_percent = watchface_set_battery_percent,
+    .set_hrm = watchface_set_hrm,
+    .set_step = watchface_set_step,
+    .set_time = watchface_set_time,
+    .set_ble_connected = watchface_set_ble_connected,
+    .set_num_notifcations = watchface_set_num_notifcations,
+    .set_weather = watchface_set_weather,
+    .set_date = watchface_set_date,
+    .set_watch_env_sensors = watchface_set_watch_env_sensors,
+    .ui_invalidate_cached = watchface_ui_invalidate_cached,
+};
+
+static int watchface_init(void)
+{
+    watchface_app_register_ui(&ui_api);
+
+    return 0;
+}
+
+SYS_INIT(watchface_init, APPLICATION, WATCHFACE_UI_INIT_PRIO);
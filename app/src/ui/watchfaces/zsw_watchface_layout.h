@@ -0,0 +1,87 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+
+/*
+* Binary watchface layout stored on littlefs in ZSW_WATCHFACE_LAYOUT_DIR,
+* one file per watchface, see scripts/create_watchface_layout.py.
+* All values are little endian. Images are referenced by their file name
+* in the external flash resource image (lvgl_raw_partition).
+*/
+
+#define ZSW_WATCHFACE_LAYOUT_DIR            "/lvgl_lfs/watchfaces"
+#define ZSW_WATCHFACE_LAYOUT_MAGIC          0x3146575A // "ZWF1"
+#define ZSW_WATCHFACE_LAYOUT_VERSION        1
+#define ZSW_WATCHFACE_LAYOUT_NAME_LEN       16
+#define ZSW_WATCHFACE_LAYOUT_MAX_ELEMENTS   32
+
+typedef enum zsw_watchface_layout_element_type {
+    ZSW_WATCHFACE_LAYOUT_ELEMENT_IMG,
+    ZSW_WATCHFACE_LAYOUT_ELEMENT_LABEL,
+    ZSW_WATCHFACE_LAYOUT_ELEMENT_ARC,
+    ZSW_WATCHFACE_LAYOUT_ELEMENT_NUM,
+} zsw_watchface_layout_element_type_t;
+
+typedef enum zsw_watchface_layout_binding {
+    ZSW_WATCHFACE_LAYOUT_BINDING_NONE,
+    ZSW_WATCHFACE_LAYOUT_BINDING_HOUR_HAND,
+    ZSW_WATCHFACE_LAYOUT_BINDING_MINUTE_HAND,
+    ZSW_WATCHFACE_LAYOUT_BINDING_SECOND_HAND,
+    ZSW_WATCHFACE_LAYOUT_BINDING_TIME,
+    ZSW_WATCHFACE_LAYOUT_BINDING_SECONDS,
+    ZSW_WATCHFACE_LAYOUT_BINDING_DATE,
+    ZSW_WATCHFACE_LAYOUT_BINDING_BATTERY,
+    ZSW_WATCHFACE_LAYOUT_BINDING_STEPS,
+    ZSW_WATCHFACE_LAYOUT_BINDING_HRM,
+    ZSW_WATCHFACE_LAYOUT_BINDING_NOTIFICATIONS,
+    ZSW_WATCHFACE_LAYOUT_BINDING_BLE_CONNECTED,
+    ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_TEMPERATURE,
+    ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_ICON,
+    ZSW_WATCHFACE_LAYOUT_BINDING_TEMPERATURE,
+    ZSW_WATCHFACE_LAYOUT_BINDING_HUMIDITY,
+    ZSW_WATCHFACE_LAYOUT_BINDING_PRESSURE,
+    ZSW_WATCHFACE_LAYOUT_BINDING_NUM,
+} zsw_watchface_layout_binding_t;
+
+typedef struct __packed zsw_watchface_layout_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t num_elements;
+    uint32_t bg_color;                              // 0xRRGGBB
+    char bg_img[ZSW_WATCHFACE_LAYOUT_NAME_LEN];      // Empty for no background image
+} zsw_watchface_layout_header_t;
+
+typedef struct __packed zsw_watchface_layout_element {
+    uint8_t type;           // zsw_watchface_layout_element_type_t
+    uint8_t binding;        // zsw_watchface_layout_binding_t
+    uint8_t align;          // lv_align_t relative to the screen
+    uint8_t font;           // Index in the renderer font table, labels only
+    int16_t x;
+    int16_t y;
+    int16_t width;          // 0 means size to content
+    int16_t height;
+    uint32_t color;         // 0xRRGGBB, text/arc indicator/image recolor, 0 is no recolor for images
+    int16_t pivot_x;        // Rotation pivot for hands
+    int16_t pivot_y;
+    int32_t max_value;      // Arc range
+    // Image file name for images, static text for unbound labels, else suffix added after the value.
+    char src[ZSW_WATCHFACE_LAYOUT_NAME_LEN];
+} zsw_watchface_layout_element_t;
@@ -0,0 +1,501 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+
+#include "zsw_watchface_layout.h"
+#include "filesystem/zsw_storage_probe.h"
+#include "managers/zsw_mem_pressure.h"
+#include "../utils/zsw_ui_utils.h"
+#include "../../applications/watchface/watchface_app.h"
+
+LOG_MODULE_REGISTER(watchface_layout, LOG_LEVEL_INF);
+
+#define LAYOUT_FILE_SUFFIX  ".zwf"
+#define LAYOUT_IMG_PATH_LEN (sizeof("S:") + ZSW_WATCHFACE_LAYOUT_NAME_LEN)
+
+typedef struct loaded_layout {
+    zsw_watchface_layout_header_t header;
+    zsw_watchface_layout_element_t *elements;
+    char bg_img_path[LAYOUT_IMG_PATH_LEN];
+    size_t ram_usage;
+    uint32_t switch_time_ms;
+    watchface_ui_api_t api;
+} loaded_layout_t;
+
+static void layout_show(loaded_layout_t *layout, watchface_app_evt_listener evt_cb);
+static void watchface_ui_invalidate_cached(void);
+
+static const lv_font_t *fonts[] = {
+    &lv_font_montserrat_10,
+    &lv_font_montserrat_12,
+    &lv_font_montserrat_14,
+    &lv_font_montserrat_16,
+    &lv_font_montserrat_18,
+    &lv_font_montserrat_20,
+};
+
+static const char *days[] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
+
+static loaded_layout_t layouts[CONFIG_WATCHFACE_LAYOUTS_MAX_NUM];
+static uint8_t num_layouts;
+
+static loaded_layout_t *active_layout;
+static watchface_app_evt_listener evt_listener;
+static lv_obj_t *root_page;
+static lv_obj_t *element_objs[ZSW_WATCHFACE_LAYOUT_MAX_ELEMENTS];
+
+// Remember last values as if no change then
+// no reason to waste resourses and redraw
+static int32_t last_values[ZSW_WATCHFACE_LAYOUT_BINDING_NUM];
+
+// watchface_ui_api_t has no user data, so each layout slot gets its own show function.
+#define LAYOUT_SHOW_FN_DEFINE(i, _)                                         \
+    static void layout_show_##i(watchface_app_evt_listener evt_cb)          \
+    {                                                                       \
+        layout_show(&layouts[i], evt_cb);                                   \
+    }
+#define LAYOUT_SHOW_FN_REF(i, _) layout_show_##i
+
+LISTIFY(CONFIG_WATCHFACE_LAYOUTS_MAX_NUM, LAYOUT_SHOW_FN_DEFINE, ())
+
+static void (*const show_fns[])(watchface_app_evt_listener) = {
+    LISTIFY(CONFIG_WATCHFACE_LAYOUTS_MAX_NUM, LAYOUT_SHOW_FN_REF, (,))
+};
+
+static void element_click_cb(lv_event_t *e)
+{
+    zsw_watchface_layout_element_t *element = lv_event_get_user_data(e);
+
+    if (!evt_listener) {
+        return;
+    }
+
+    switch (element->binding) {
+        case ZSW_WATCHFACE_LAYOUT_BINDING_BATTERY:
+            evt_listener(WATCHFACE_APP_EVT_CLICK_BATT);
+            break;
+        case ZSW_WATCHFACE_LAYOUT_BINDING_STEPS:
+            evt_listener(WATCHFACE_APP_EVT_CLICK_STEP);
+            break;
+        case ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_TEMPERATURE:
+        case ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_ICON:
+            evt_listener(WATCHFACE_APP_EVT_CLICK_WEATHER);
+            break;
+        default:
+            break;
+    }
+}
+
+static lv_obj_t *create_element(lv_obj_t *parent, zsw_watchface_layout_element_t *element)
+{
+    lv_obj_t *obj;
+    char img_path[LAYOUT_IMG_PATH_LEN];
+
+    switch (element->type) {
+        case ZSW_WATCHFACE_LAYOUT_ELEMENT_IMG:
+            obj = lv_img_create(parent);
+            if (element->src[0] != '\0') {
+                snprintf(img_path, sizeof(img_path), "S:%s", element->src);
+                lv_img_set_src(obj, img_path);
+            }
+            if (element->pivot_x || element->pivot_y) {
+                lv_img_set_pivot(obj, element->pivot_x, element->pivot_y);
+            }
+            if (element->color) {
+                lv_obj_set_style_img_recolor(obj, lv_color_hex(element->color), LV_PART_MAIN | LV_STATE_DEFAULT);
+                lv_obj_set_style_img_recolor_opa(obj, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+            }
+            break;
+        case ZSW_WATCHFACE_LAYOUT_ELEMENT_LABEL:
+            obj = lv_label_create(parent);
+            lv_label_set_text_static(obj, element->binding == ZSW_WATCHFACE_LAYOUT_BINDING_NONE ? element->src : "");
+            lv_obj_set_style_text_color(obj, lv_color_hex(element->color), LV_PART_MAIN | LV_STATE_DEFAULT);
+            lv_obj_set_style_text_font(obj, fonts[MIN(element->font, ARRAY_SIZE(fonts) - 1)],
+                                       LV_PART_MAIN | LV_STATE_DEFAULT);
+            break;
+        case ZSW_WATCHFACE_LAYOUT_ELEMENT_ARC:
+            obj = lv_arc_create(parent);
+            lv_arc_set_range(obj, 0, element->max_value > 0 ? element->max_value : 100);
+            lv_arc_set_value(obj, 0);
+            lv_obj_remove_style(obj, NULL, LV_PART_KNOB);
+            lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+            lv_obj_set_style_arc_color(obj, lv_color_hex(element->color), LV_PART_INDICATOR | LV_STATE_DEFAULT);
+            lv_obj_set_style_arc_width(obj, 4, LV_PART_MAIN | LV_STATE_DEFAULT);
+            lv_obj_set_style_arc_width(obj, 4, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+            break;
+        default:
+            return NULL;
+    }
+
+    lv_obj_set_width(obj, element->width > 0 ? element->width : LV_SIZE_CONTENT);
+    lv_obj_set_height(obj, element->height > 0 ? element->height : LV_SIZE_CONTENT);
+    lv_obj_align(obj, element->align, element->x, element->y);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+
+    if (element->binding == ZSW_WATCHFACE_LAYOUT_BINDING_BATTERY ||
+        element->binding == ZSW_WATCHFACE_LAYOUT_BINDING_STEPS ||
+        element->binding == ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_TEMPERATURE ||
+        element->binding == ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_ICON) {
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(obj, element_click_cb, LV_EVENT_CLICKED, element);
+    }
+
+    return obj;
+}
+
+static void layout_show(loaded_layout_t *layout, watchface_app_evt_listener evt_cb)
+{
+    lv_mem_monitor_t mem_before;
+    lv_mem_monitor_t mem_after;
+    uint32_t start = k_uptime_get_32();
+
+    lv_mem_monitor(&mem_before);
+
+    active_layout = layout;
+    evt_listener = evt_cb;
+    lv_obj_clear_flag(lv_scr_act(), LV_OBJ_FLAG_SCROLLABLE);
+    root_page = lv_obj_create(lv_scr_act());
+    watchface_ui_invalidate_cached();
+
+    lv_obj_clear_flag(root_page, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scrollbar_mode(root_page, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_style_border_width(root_page, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(root_page, 0, LV_PART_MAIN);
+    lv_obj_set_size(root_page, 240, 240);
+    lv_obj_align(root_page, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_set_style_bg_color(root_page, lv_color_hex(layout->header.bg_color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    if (layout->bg_img_path[0] != '\0') {
+        lv_obj_set_style_bg_img_src(root_page, layout->bg_img_path, LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+
+    for (int i = 0; i < layout->header.num_elements; i++) {
+        element_objs[i] = create_element(root_page, &layout->elements[i]);
+    }
+
+    lv_mem_monitor(&mem_after);
+    layout->switch_time_ms = k_uptime_get_32() - start;
+    LOG_INF("Layout %d shown in %d ms, %d bytes LVGL heap, %d bytes cached layout",
+            (int)(layout - layouts), layout->switch_time_ms,
+            (int)mem_before.free_size - (int)mem_after.free_size, (int)layout->ram_usage);
+}
+
+static void watchface_remove(void)
+{
+    if (!root_page) {
+        return;
+    }
+    lv_obj_del(root_page);
+    root_page = NULL;
+    active_layout = NULL;
+    evt_listener = NULL;
+    memset(element_objs, 0, sizeof(element_objs));
+}
+
+static bool update_cached(zsw_watchface_layout_binding_t binding, int32_t value)
+{
+    if (last_values[binding] == value) {
+        return false;
+    }
+    last_values[binding] = value;
+    return true;
+}
+
+static void update_elements(zsw_watchface_layout_binding_t binding, int32_t value, const char *text)
+{
+    zsw_watchface_layout_element_t *element;
+    lv_obj_t *obj;
+
+    for (int i = 0; i < active_layout->header.num_elements; i++) {
+        element = &active_layout->elements[i];
+        obj = element_objs[i];
+        if (element->binding != binding || !obj) {
+            continue;
+        }
+
+        switch (element->type) {
+            case ZSW_WATCHFACE_LAYOUT_ELEMENT_IMG:
+                if (binding == ZSW_WATCHFACE_LAYOUT_BINDING_BLE_CONNECTED) {
+                    if (value) {
+                        lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+                    } else {
+                        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+                    }
+                } else if (binding == ZSW_WATCHFACE_LAYOUT_BINDING_HOUR_HAND ||
+                           binding == ZSW_WATCHFACE_LAYOUT_BINDING_MINUTE_HAND ||
+                           binding == ZSW_WATCHFACE_LAYOUT_BINDING_SECOND_HAND) {
+                    lv_img_set_angle(obj, value);
+                }
+                // Other images, like a steps or battery icon, are only tappable.
+                break;
+            case ZSW_WATCHFACE_LAYOUT_ELEMENT_LABEL:
+                lv_label_set_text_fmt(obj, "%s%s", text, element->src);
+                break;
+            case ZSW_WATCHFACE_LAYOUT_ELEMENT_ARC:
+                lv_arc_set_value(obj, value);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void update_value(zsw_watchface_layout_binding_t binding, int32_t value)
+{
+    char buf[12];
+
+    if (!root_page || !update_cached(binding, value)) {
+        return;
+    }
+
+    snprintf(buf, sizeof(buf), "%d", value);
+    update_elements(binding, value, buf);
+}
+
+static void watchface_set_battery_percent(int32_t percent, int32_t value)
+{
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_BATTERY, percent);
+}
+
+static void watchface_set_hrm(int32_t value)
+{
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_HRM, value);
+}
+
+static void watchface_set_step(int32_t value)
+{
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_STEPS, value);
+}
+
+static void watchface_set_time(int32_t hour, int32_t minute, int32_t second)
+{
+    char buf[6];
+    int hour_minute_offset;
+
+    if (!root_page) {
+        return;
+    }
+
+    if (update_cached(ZSW_WATCHFACE_LAYOUT_BINDING_TIME, hour * 60 + minute)) {
+        snprintf(buf, sizeof(buf), "%02d:%02d", hour, minute);
+        update_elements(ZSW_WATCHFACE_LAYOUT_BINDING_TIME, hour * 60 + minute, buf);
+    }
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_SECONDS, second);
+
+    // Move hour hand with greater resolution than 12.
+    hour_minute_offset = (int)((minute / 60.0) * (3600 / 12.0));
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_HOUR_HAND, hour_minute_offset + (hour % 12) * (3600 / 12));
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_MINUTE_HAND, minute * (3600 / 60));
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_SECOND_HAND, second * (3600 / 60));
+}
+
+static void watchface_set_num_notifcations(int32_t value)
+{
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_NOTIFICATIONS, value);
+}
+
+static void watchface_set_ble_connected(bool connected)
+{
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_BLE_CONNECTED, connected);
+}
+
+static void watchface_set_weather(int8_t temperature, int weather_code)
+{
+    const lv_img_dsc_t *icon;
+    lv_color_t icon_color;
+
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_TEMPERATURE, temperature);
+
+    if (!root_page || !update_cached(ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_ICON, weather_code)) {
+        return;
+    }
+
+    icon = zsw_ui_utils_icon_from_weather_code(weather_code, &icon_color);
+    for (int i = 0; i < active_layout->header.num_elements; i++) {
+        if (active_layout->elements[i].binding == ZSW_WATCHFACE_LAYOUT_BINDING_WEATHER_ICON && element_objs[i] &&
+            active_layout->elements[i].type == ZSW_WATCHFACE_LAYOUT_ELEMENT_IMG) {
+            lv_img_set_src(element_objs[i], icon);
+            lv_obj_set_style_img_recolor(element_objs[i], icon_color, LV_PART_MAIN | LV_STATE_DEFAULT);
+        }
+    }
+}
+
+static void watchface_set_date(int day_of_week, int date)
+{
+    char buf[8];
+
+    if (!root_page || !update_cached(ZSW_WATCHFACE_LAYOUT_BINDING_DATE, day_of_week * 100 + date)) {
+        return;
+    }
+
+    snprintf(buf, sizeof(buf), "%s %d", days[day_of_week % ARRAY_SIZE(days)], date);
+    update_elements(ZSW_WATCHFACE_LAYOUT_BINDING_DATE, date, buf);
+}
+
+static void watchface_set_watch_env_sensors(int temperature, int humidity, int pressure)
+{
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_TEMPERATURE, temperature);
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_HUMIDITY, humidity);
+    update_value(ZSW_WATCHFACE_LAYOUT_BINDING_PRESSURE, pressure / 100);
+}
+
+static void watchface_ui_invalidate_cached(void)
+{
+    for (int i = 0; i < ARRAY_SIZE(last_values); i++) {
+        last_values[i] = INT32_MIN;
+    }
+}
+
+static int layout_validate(const zsw_watchface_layout_header_t *header, size_t file_size)
+{
+    if (header->magic != ZSW_WATCHFACE_LAYOUT_MAGIC || header->version != ZSW_WATCHFACE_LAYOUT_VERSION) {
+        return -EINVAL;
+    }
+    if (header->num_elements == 0 || header->num_elements > ZSW_WATCHFACE_LAYOUT_MAX_ELEMENTS) {
+        return -E2BIG;
+    }
+    if (file_size != sizeof(*header) + header->num_elements * sizeof(zsw_watchface_layout_element_t)) {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static int layout_load(const char *path, size_t file_size, loaded_layout_t *layout)
+{
+    struct fs_file_t file;
+    size_t elements_size;
+    uint32_t start = zsw_storage_probe_begin();
+    int rc;
+
+    fs_file_t_init(&file);
+    rc = fs_open(&file, path, FS_O_READ);
+    if (rc < 0) {
+        return rc;
+    }
+
+    rc = fs_read(&file, &layout->header, sizeof(layout->header));
+    if (rc != sizeof(layout->header)) {
+        rc = rc < 0 ? rc : -EIO;
+        goto out;
+    }
+
+    rc = layout_validate(&layout->header, file_size);
+    if (rc < 0) {
+        goto out;
+    }
+
+    elements_size = layout->header.num_elements * sizeof(zsw_watchface_layout_element_t);
+    layout->elements = k_malloc(elements_size);
+    if (!layout->elements) {
+        zsw_mem_pressure_report_alloc_failure("watchface layout", elements_size);
+        rc = -ENOMEM;
+        goto out;
+    }
+
+    rc = fs_read(&file, layout->elements, elements_size);
+    if (rc != elements_size) {
+        rc = rc < 0 ? rc : -EIO;
+        k_free(layout->elements);
+        layout->elements = NULL;
+        goto out;
+    }
+
+    for (int i = 0; i < layout->header.num_elements; i++) {
+        layout->elements[i].src[ZSW_WATCHFACE_LAYOUT_NAME_LEN - 1] = '\0';
+    }
+    layout->header.bg_img[ZSW_WATCHFACE_LAYOUT_NAME_LEN - 1] = '\0';
+    if (layout->header.bg_img[0] != '\0') {
+        snprintf(layout->bg_img_path, sizeof(layout->bg_img_path), "S:%s", layout->header.bg_img);
+    }
+    layout->ram_usage = sizeof(*layout) + elements_size;
+    rc = 0;
+
+out:
+    fs_close(&file);
+    zsw_storage_probe_end("layout load", start);
+    return rc;
+}
+
+static int watchface_layouts_init(void)
+{
+    struct fs_dir_t dir;
+    static struct fs_dirent entry;
+    char path[sizeof(ZSW_WATCHFACE_LAYOUT_DIR) + sizeof(entry.name) + 1];
+    loaded_layout_t *layout;
+    size_t name_len;
+    int rc;
+
+    fs_dir_t_init(&dir);
+    rc = fs_opendir(&dir, ZSW_WATCHFACE_LAYOUT_DIR);
+    if (rc < 0) {
+        LOG_DBG("No watchface layouts in %s (%d)", ZSW_WATCHFACE_LAYOUT_DIR, rc);
+        return 0;
+    }
+
+    while (num_layouts < ARRAY_SIZE(layouts)) {
+        rc = fs_readdir(&dir, &entry);
+        if (rc < 0 || entry.name[0] == '\0') {
+            break;
+        }
+
+        name_len = strlen(entry.name);
+        if (entry.type != FS_DIR_ENTRY_FILE || name_len <= strlen(LAYOUT_FILE_SUFFIX) ||
+            strcmp(&entry.name[name_len - strlen(LAYOUT_FILE_SUFFIX)], LAYOUT_FILE_SUFFIX) != 0) {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s", ZSW_WATCHFACE_LAYOUT_DIR, entry.name);
+        layout = &layouts[num_layouts];
+        rc = layout_load(path, entry.size, layout);
+        if (rc < 0) {
+            LOG_ERR("Failed loading layout %s: %d", entry.name, rc);
+            continue;
+        }
+
+        layout->api = (watchface_ui_api_t) {
+            .show = show_fns[num_layouts],
+            .remove = watchface_remove,
+            .set_battery_percent = watchface_set_battery_percent,
+            .set_hrm = watchface_set_hrm,
+            .set_step = watchface_set_step,
+            .set_time = watchface_set_time,
+            .set_ble_connected = watchface_set_ble_connected,
+            .set_num_notifcations = watchface_set_num_notifcations,
+            .set_weather = watchface_set_weather,
+            .set_date = watchface_set_date,
+            .set_watch_env_sensors = watchface_set_watch_env_sensors,
+            .ui_invalidate_cached = watchface_ui_invalidate_cached,
+        };
+        watchface_app_register_ui(&layout->api);
+        LOG_INF("Loaded layout %s: %d elements, %d bytes RAM", entry.name, layout->header.num_elements,
+                (int)layout->ram_usage);
+        num_layouts++;
+    }
+
+    fs_closedir(&dir);
+
+    return 0;
+}
+
+SYS_INIT(watchface_layouts_init, APPLICATION, WATCHFACE_UI_INIT_PRIO);
@@ -0,0 +1,144 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/timing/timing.h>
+#include <zephyr/logging/log.h>
+#include <lvgl.h>
+
+#include "zsw_cycle_prof.h"
+#include "zsw_ram_code.h"
+
+LOG_MODULE_REGISTER(zsw_cycle_prof, LOG_LEVEL_INF);
+
+typedef struct probe_stats {
+    uint32_t count;
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+} probe_stats_t;
+
+static void report_work_handler(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(report_work, report_work_handler);
+
+static const char *probe_names[ZSW_CYCLE_PROF_NUM] = {
+    [ZSW_CYCLE_PROF_LVGL_REFRESH] = "lvgl refresh",
+    [ZSW_CYCLE_PROF_LVGL_BLEND] = "lvgl blend",
+    [ZSW_CYCLE_PROF_BLE_RX] = "ble rx",
+    [ZSW_CYCLE_PROF_GB_PARSE] = "gb parse",
+    [ZSW_CYCLE_PROF_IMU_TRIGGER] = "imu trigger",
+};
+
+static probe_stats_t probes[ZSW_CYCLE_PROF_NUM];
+static struct k_spinlock lock;
+static void (*lvgl_blend)(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc);
+
+uint64_t zsw_cycle_prof_begin(void)
+{
+    return timing_counter_get();
+}
+
+void zsw_cycle_prof_end(zsw_cycle_prof_probe_t probe, uint64_t start)
+{
+    timing_t begin = start;
+    timing_t end = timing_counter_get();
+    uint32_t cycles = timing_cycles_get(&begin, &end);
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    probes[probe].count++;
+    probes[probe].total_cycles += cycles;
+    probes[probe].max_cycles = MAX(probes[probe].max_cycles, cycles);
+    k_spin_unlock(&lock, key);
+}
+
+void zsw_cycle_prof_report(void)
+{
+    probe_stats_t stats[ZSW_CYCLE_PROF_NUM];
+    bool reported[ZSW_CYCLE_PROF_NUM] = {0};
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    memcpy(stats, probes, sizeof(stats));
+    memset(probes, 0, sizeof(probes));
+    k_spin_unlock(&lock, key);
+
+    LOG_INF("Hottest first, %d bytes code in RAM:", zsw_ram_code_get_size());
+    for (int n = 0; n < ZSW_CYCLE_PROF_NUM; n++) {
+        int hottest = -1;
+
+        for (int i = 0; i < ZSW_CYCLE_PROF_NUM; i++) {
+            if (!reported[i] && (hottest < 0 || stats[i].total_cycles > stats[hottest].total_cycles)) {
+                hottest = i;
+            }
+        }
+        reported[hottest] = true;
+        if (stats[hottest].count == 0) {
+            continue;
+        }
+        LOG_INF("%s: %d calls, %llu cycles, avg %llu max %d", probe_names[hottest], stats[hottest].count,
+                stats[hottest].total_cycles, stats[hottest].total_cycles / stats[hottest].count,
+                stats[hottest].max_cycles);
+    }
+}
+
+static void blend_probe(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    uint64_t start = zsw_cycle_prof_begin();
+
+    lvgl_blend(draw_ctx, dsc);
+    zsw_cycle_prof_end(ZSW_CYCLE_PROF_LVGL_BLEND, start);
+}
+
+static void report_work_handler(struct k_work *work)
+{
+    zsw_cycle_prof_report();
+    k_work_schedule(&report_work, K_SECONDS(CONFIG_ZSW_CYCLE_PROF_REPORT_INTERVAL_S));
+}
+
+void zsw_cycle_prof_attach_lvgl(void)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_draw_sw_ctx_t *draw_ctx;
+
+    if (!disp || !disp->driver->draw_ctx) {
+        LOG_WRN("No LVGL display, %s is not counted", probe_names[ZSW_CYCLE_PROF_LVGL_BLEND]);
+        return;
+    }
+
+    draw_ctx = (lv_draw_sw_ctx_t *)disp->driver->draw_ctx;
+    if (draw_ctx->blend == blend_probe) {
+        return;
+    }
+
+    // LVGL has no hook around blending, wrap the software renderer's blend
+    // function instead.
+    lvgl_blend = draw_ctx->blend;
+    draw_ctx->blend = blend_probe;
+}
+
+static int zsw_cycle_prof_init(void)
+{
+    timing_init();
+    timing_start();
+
+    k_work_schedule(&report_work, K_SECONDS(CONFIG_ZSW_CYCLE_PROF_REPORT_INTERVAL_S));
+
+    return 0;
+}
+
+SYS_INIT(zsw_cycle_prof_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
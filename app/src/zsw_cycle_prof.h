@@ -0,0 +1,65 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+*   Cycle counts for code paths that run often, to find which ones are worth
+*   moving to RAM with ZSW_HOT_FUNC, see zsw_ram_code.h. Compare the report
+*   with CONFIG_ZSW_RAM_HOT_CODE enabled and disabled.
+*/
+typedef enum zsw_cycle_prof_probe_t {
+    ZSW_CYCLE_PROF_LVGL_REFRESH, // One lv_task_handler call.
+    ZSW_CYCLE_PROF_LVGL_BLEND, // One LVGL software blend (fill or copy of an area).
+    ZSW_CYCLE_PROF_BLE_RX, // Gadgetbridge framing of one received BLE packet.
+    ZSW_CYCLE_PROF_GB_PARSE, // Parsing one complete Gadgetbridge message.
+    ZSW_CYCLE_PROF_IMU_TRIGGER, // IMU trigger handler.
+    ZSW_CYCLE_PROF_NUM,
+} zsw_cycle_prof_probe_t;
+
+#ifdef CONFIG_ZSW_CYCLE_PROF
+uint64_t zsw_cycle_prof_begin(void);
+
+/*
+*   Add the cycles since start, from zsw_cycle_prof_begin, to probe.
+*/
+void zsw_cycle_prof_end(zsw_cycle_prof_probe_t probe, uint64_t start);
+
+/*
+*   Log calls, total, average and max cycles per probe, hottest first, then reset.
+*/
+void zsw_cycle_prof_report(void);
+
+/*
+*   Start counting ZSW_CYCLE_PROF_LVGL_BLEND. Call once the LVGL display is
+*   registered, a warning is logged if there is none.
+*/
+void zsw_cycle_prof_attach_lvgl(void);
+#else
+static inline uint64_t zsw_cycle_prof_begin(void)
+{
+    return 0;
+}
+
+static inline void zsw_cycle_prof_end(zsw_cycle_prof_probe_t probe, uint64_t start) {}
+
+static inline void zsw_cycle_prof_report(void) {}
+
+static inline void zsw_cycle_prof_attach_lvgl(void) {}
+#endif
@@ -0,0 +1,51 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/linker/linker-defs.h>
+#include <zephyr/logging/log.h>
+
+#include "zsw_ram_code.h"
+
+LOG_MODULE_REGISTER(zsw_ram_code, LOG_LEVEL_INF);
+
+// Defined by the generated linker script only when a file is relocated
+// with zephyr_code_relocate, weak so the size reads as 0 otherwise.
+extern char __ram_text_reloc_start[] __attribute__((weak));
+extern char __ram_text_reloc_end[] __attribute__((weak));
+
+uint32_t zsw_ram_code_get_size(void)
+{
+    uint32_t size = (uint32_t)__ramfunc_size;
+
+    if (__ram_text_reloc_start && __ram_text_reloc_end) {
+        size += __ram_text_reloc_end - __ram_text_reloc_start;
+    }
+
+    return size;
+}
+
+// Over budget fails the link, see zsw_ram_code.ld.
+static int zsw_ram_code_init(void)
+{
+    LOG_INF("%d of %d bytes RAM code budget used", zsw_ram_code_get_size(), CONFIG_ZSW_RAM_HOT_CODE_BUDGET_BYTES);
+
+    return 0;
+}
+
+SYS_INIT(zsw_ram_code_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,46 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+*   Functions marked ZSW_HOT_FUNC run from RAM when CONFIG_ZSW_RAM_HOT_CODE
+*   is enabled, so they don't compete for the instruction cache and flash
+*   wait states. Only mark code that zsw_cycle_prof shows to be hot, the
+*   total must stay within CONFIG_ZSW_RAM_HOT_CODE_BUDGET_BYTES.
+*/
+#ifdef CONFIG_ZSW_RAM_HOT_CODE
+#include <zephyr/linker/section_tags.h>
+#define ZSW_HOT_FUNC __ramfunc
+#else
+#define ZSW_HOT_FUNC
+#endif
+
+/*
+*   Bytes of code running from RAM, ZSW_HOT_FUNC functions and relocated files.
+*   Returns 0 if CONFIG_ZSW_RAM_HOT_CODE is not enabled.
+*/
+#ifdef CONFIG_ZSW_RAM_HOT_CODE
+uint32_t zsw_ram_code_get_size(void);
+#else
+static inline uint32_t zsw_ram_code_get_size(void)
+{
+    return 0;
+}
+#endif
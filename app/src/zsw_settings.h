@@ -22,4 +22,7 @@ typedef bool zsw_settings_ble_aoa_en_t;
 
 typedef int32_t zsw_settings_ble_aoa_int_t;
 #define ZSW_SETTINGS_KEY_BLE_AOA_INT "aoa_int"
-#define ZSW_SETTINGS_BLE_AOA_INT (ZSW_SETTINGS_PATH "/" ZSW_SETTINGS_KEY_BLE_AOA_INT)
\ No newline at end of file
+#define ZSW_SETTINGS_BLE_AOA_INT (ZSW_SETTINGS_PATH "/" ZSW_SETTINGS_KEY_BLE_AOA_INT)
+
+// Not under ZSW_SETTINGS_PATH, as it is owned by the QR code app and not the settings app.
+#define ZSW_SETTINGS_QR_CODE_TEXT "qr_code/text"
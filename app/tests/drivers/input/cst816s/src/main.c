@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2023 Jakob Krantz <mail@jakobkrantz.se>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/pm/device.h>
+
+#include "emul_cst816s.h"
+
+#define TOUCH_NODE                  DT_NODELABEL(touch)
+
+#define CST816S_REG_POWER_MODE      0xA5
+#define CST816S_POWER_MODE_SLEEP    0x03
+
+// Reset pulse, 50 ms wait and then 100 + 200 + 400 + 800 ms of retries.
+#define RESUME_ALL_RETRIES_MS       1600
+
+static const struct device *touch_dev = DEVICE_DT_GET(TOUCH_NODE);
+static const struct emul *touch_emul = EMUL_DT_GET(TOUCH_NODE);
+static const struct gpio_dt_spec irq_gpio = GPIO_DT_SPEC_GET(TOUCH_NODE, irq_gpios);
+
+static struct gpio_callback irq_cb;
+static uint32_t num_irqs;
+
+static void irq_counter(const struct device *port, struct gpio_callback *cb, uint32_t pins)
+{
+    num_irqs++;
+}
+
+static void touch(int count)
+{
+    for (int i = 0; i < count; i++) {
+        // Active low, the driver triggers on the falling edge.
+        gpio_emul_input_set(irq_gpio.port, irq_gpio.pin, 0);
+        k_msleep(5);
+        gpio_emul_input_set(irq_gpio.port, irq_gpio.pin, 1);
+        k_msleep(5);
+    }
+}
+
+static void reset_counters(void)
+{
+    num_irqs = 0;
+    cst816s_emul_reset_counters(touch_emul);
+}
+
+static void *cst816s_setup(void)
+{
+    zassert_true(device_is_ready(touch_dev));
+
+    gpio_emul_input_set(irq_gpio.port, irq_gpio.pin, 1);
+    gpio_init_callback(&irq_cb, irq_counter, BIT(irq_gpio.pin));
+    zassert_ok(gpio_add_callback(irq_gpio.port, &irq_cb));
+
+    return NULL;
+}
+
+static void cst816s_before(void *fixture)
+{
+    enum pm_device_state state;
+
+    cst816s_emul_set_unresponsive(touch_emul, false);
+    pm_device_state_get(touch_dev, &state);
+    if (state == PM_DEVICE_STATE_SUSPENDED) {
+        zassert_ok(pm_device_action_run(touch_dev, PM_DEVICE_ACTION_RESUME));
+        k_msleep(RESUME_ALL_RETRIES_MS);
+    }
+    reset_counters();
+}
+
+ZTEST(cst816s, test_touch_read_when_active)
+{
+    touch(10);
+
+    zassert_equal(num_irqs, 10);
+    zassert_true(cst816s_emul_get_num_reads(touch_emul) >= 10);
+}
+
+ZTEST(cst816s, test_no_interrupts_or_i2c_while_suspended)
+{
+    zassert_ok(pm_device_action_run(touch_dev, PM_DEVICE_ACTION_SUSPEND));
+    zassert_equal(cst816s_emul_get_reg(touch_emul, CST816S_REG_POWER_MODE), CST816S_POWER_MODE_SLEEP);
+
+    reset_counters();
+    touch(50);
+    k_msleep(100);
+
+    zassert_equal(num_irqs, 0, "%u interrupts while suspended", num_irqs);
+    zassert_equal(cst816s_emul_get_num_reads(touch_emul), 0);
+    zassert_equal(cst816s_emul_get_num_writes(touch_emul), 0);
+
+    zassert_ok(pm_device_action_run(touch_dev, PM_DEVICE_ACTION_RESUME));
+    k_msleep(100);
+    reset_counters();
+    touch(10);
+
+    zassert_equal(num_irqs, 10);
+    zassert_true(cst816s_emul_get_num_reads(touch_emul) >= 10);
+}
+
+ZTEST(cst816s, test_resume_retries_configuration)
+{
+    zassert_ok(pm_device_action_run(touch_dev, PM_DEVICE_ACTION_SUSPEND));
+
+    // First configuration attempt after resume fails, a later retry succeeds.
+    cst816s_emul_set_unresponsive(touch_emul, true);
+    zassert_ok(pm_device_action_run(touch_dev, PM_DEVICE_ACTION_RESUME));
+    k_msleep(120);
+    cst816s_emul_set_unresponsive(touch_emul, false);
+    k_msleep(RESUME_ALL_RETRIES_MS);
+
+    reset_counters();
+    touch(10);
+
+    zassert_equal(num_irqs, 10);
+    zassert_true(cst816s_emul_get_num_reads(touch_emul) >= 10);
+}
+
+ZTEST(cst816s, test_resume_enables_touch_after_all_retries_fail)
+{
+    zassert_ok(pm_device_action_run(touch_dev, PM_DEVICE_ACTION_SUSPEND));
+
+    cst816s_emul_set_unresponsive(touch_emul, true);
+    zassert_ok(pm_device_action_run(touch_dev, PM_DEVICE_ACTION_RESUME));
+    k_msleep(RESUME_ALL_RETRIES_MS + 100);
+    cst816s_emul_set_unresponsive(touch_emul, false);
+
+    reset_counters();
+    touch(10);
+
+    zassert_equal(num_irqs, 10);
+    zassert_true(cst816s_emul_get_num_reads(touch_emul) >= 10);
+}
+
+ZTEST_SUITE(cst816s, NULL, cst816s_setup, cst816s_before, NULL, NULL);
@@ -0,0 +1,166 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "sensors/zsw_sensor_history.h"
+
+#define HISTORY_LEN         CONFIG_ZSW_SENSOR_HISTORY_LEN
+#define NUM_READERS         3
+#define NUM_WRITES          20000
+#define STACK_SIZE          (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define THREAD_PRIO         K_PRIO_PREEMPT(5)
+
+typedef struct reader_result_t {
+    uint32_t num_reads;
+    uint32_t num_samples;
+    uint32_t num_busy;
+    uint32_t num_invalid;
+    uint32_t num_torn;
+    uint32_t num_out_of_order;
+} reader_result_t;
+
+K_THREAD_STACK_DEFINE(writer_stack, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(reader_stacks, NUM_READERS, STACK_SIZE);
+
+static struct k_thread writer_thread;
+static struct k_thread reader_threads[NUM_READERS];
+static reader_result_t reader_results[NUM_READERS];
+static atomic_t writer_done;
+
+static void push_sample(zsw_sensor_history_stream_t stream, uint32_t n)
+{
+    // All values of a sample are the same, a sample mixing two writes is detected by the readers.
+    float values[] = { n, n, n };
+
+    zsw_sensor_history_push(stream, values, ARRAY_SIZE(values));
+}
+
+static void writer(void *p1, void *p2, void *p3)
+{
+    // Start at 1, float holds every integer up to 2^24 exactly.
+    for (uint32_t n = 1; n <= NUM_WRITES; n++) {
+        push_sample(ZSW_SENSOR_HISTORY_ACCEL, n);
+        if ((n % 16) == 0) {
+            k_yield();
+        }
+    }
+    atomic_set(&writer_done, 1);
+}
+
+static void check_samples(reader_result_t *result, const zsw_sensor_history_sample_t *samples, int num)
+{
+    for (int i = 0; i < num; i++) {
+        if (samples[i].values[0] != samples[i].values[1] || samples[i].values[0] != samples[i].values[2]) {
+            result->num_torn++;
+        }
+        // Samples are copied in one consistent pass, so they must be the consecutive writes.
+        if (i > 0 && (samples[i].values[0] != samples[i - 1].values[0] + 1 ||
+                      samples[i].timestamp_ms < samples[i - 1].timestamp_ms)) {
+            result->num_out_of_order++;
+        }
+    }
+}
+
+static void reader(void *p1, void *p2, void *p3)
+{
+    reader_result_t *result = p1;
+    zsw_sensor_history_sample_t samples[HISTORY_LEN];
+    int num;
+
+    while (!atomic_get(&writer_done)) {
+        num = zsw_sensor_history_read(ZSW_SENSOR_HISTORY_ACCEL, samples, ARRAY_SIZE(samples), 0);
+        result->num_reads++;
+        if (num == -EAGAIN) {
+            result->num_busy++;
+            continue;
+        }
+        if (num < 0 || num > HISTORY_LEN) {
+            result->num_invalid++;
+            continue;
+        }
+        result->num_samples += num;
+        check_samples(result, samples, num);
+        k_yield();
+    }
+}
+
+ZTEST(sensor_history, test_read_oldest_first_after_wrap)
+{
+    zsw_sensor_history_sample_t samples[HISTORY_LEN];
+    zsw_sensor_history_sample_t latest;
+    int num;
+
+    zassert_equal(zsw_sensor_history_get_latest(ZSW_SENSOR_HISTORY_LIGHT, &latest), -ENODATA);
+
+    for (uint32_t n = 1; n <= HISTORY_LEN + 3; n++) {
+        push_sample(ZSW_SENSOR_HISTORY_LIGHT, n);
+    }
+
+    num = zsw_sensor_history_read(ZSW_SENSOR_HISTORY_LIGHT, samples, ARRAY_SIZE(samples), 0);
+    zassert_equal(num, HISTORY_LEN);
+    for (int i = 0; i < num; i++) {
+        zassert_equal(samples[i].values[0], 4 + i);
+    }
+
+    zassert_ok(zsw_sensor_history_get_latest(ZSW_SENSOR_HISTORY_LIGHT, &latest));
+    zassert_equal(latest.values[0], HISTORY_LEN + 3);
+}
+
+ZTEST(sensor_history, test_read_max_age)
+{
+    zsw_sensor_history_sample_t samples[HISTORY_LEN];
+
+    push_sample(ZSW_SENSOR_HISTORY_PRESSURE, 1);
+    k_msleep(200);
+    push_sample(ZSW_SENSOR_HISTORY_PRESSURE, 2);
+
+    zassert_equal(zsw_sensor_history_read(ZSW_SENSOR_HISTORY_PRESSURE, samples, ARRAY_SIZE(samples), 100), 1);
+    zassert_equal(samples[0].values[0], 2);
+    zassert_equal(zsw_sensor_history_read(ZSW_SENSOR_HISTORY_PRESSURE, samples, ARRAY_SIZE(samples), 0), 2);
+}
+
+ZTEST(sensor_history, test_concurrent_readers)
+{
+    atomic_set(&writer_done, 0);
+
+    for (int i = 0; i < NUM_READERS; i++) {
+        memset(&reader_results[i], 0, sizeof(reader_result_t));
+        k_thread_create(&reader_threads[i], reader_stacks[i], K_THREAD_STACK_SIZEOF(reader_stacks[i]), reader,
+                        &reader_results[i], NULL, NULL, THREAD_PRIO, 0, K_NO_WAIT);
+    }
+    k_thread_create(&writer_thread, writer_stack, K_THREAD_STACK_SIZEOF(writer_stack), writer, NULL, NULL, NULL,
+                    THREAD_PRIO, 0, K_NO_WAIT);
+
+    zassert_ok(k_thread_join(&writer_thread, K_SECONDS(30)));
+    for (int i = 0; i < NUM_READERS; i++) {
+        reader_result_t *result = &reader_results[i];
+
+        zassert_ok(k_thread_join(&reader_threads[i], K_SECONDS(5)));
+        TC_PRINT("Reader %d: %u reads, %u samples, %u busy\n", i, result->num_reads, result->num_samples,
+                 result->num_busy);
+        zassert_equal(result->num_invalid, 0, "Reader %d got %u invalid results", i, result->num_invalid);
+        zassert_equal(result->num_torn, 0, "Reader %d got %u torn samples", i, result->num_torn);
+        zassert_equal(result->num_out_of_order, 0, "Reader %d got %u inconsistent reads", i,
+                      result->num_out_of_order);
+        zassert_true(result->num_samples > 0, "Reader %d never got any samples", i);
+    }
+}
+
+ZTEST_SUITE(sensor_history, NULL, NULL, NULL, NULL, NULL);
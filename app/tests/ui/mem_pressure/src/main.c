@@ -0,0 +1,172 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <lvgl.h>
+
+#include "ui/utils/zsw_ui_mem.h"
+#include "managers/zsw_mem_pressure.h"
+
+#define NUM_CYCLES              200
+#define NUM_LABELS              4
+
+// Sizes in tenths of the largest free block after boot. A full image cache,
+// an open app and a notification do not fit together.
+#define CACHE_ENTRY_TENTHS      1
+#define CACHE_MAX_ENTRIES       6
+#define APP_BUF_TENTHS          3
+#define NOTIFICATION_BUF_DIV    8 // The notification body is an eighth.
+
+static void image_cache_shed(zsw_mem_pressure_level_t level);
+
+// Decoded images kept after the app closes, like the LVGL image cache. A
+// miss is not a failure, the image is decoded again on the next draw.
+static void *image_cache[CACHE_MAX_ENTRIES];
+static int num_cached;
+static size_t cache_entry_size;
+static size_t app_buf_size;
+static size_t notification_buf_size;
+
+static zsw_mem_pressure_handler_t image_cache_handler = {
+    .name = "test_image_cache",
+    .level = ZSW_MEM_PRESSURE_MODERATE,
+    .priority = 1,
+    .shed = image_cache_shed,
+};
+
+static void image_cache_shed(zsw_mem_pressure_level_t level)
+{
+    for (int i = 0; i < num_cached; i++) {
+        lv_mem_free(image_cache[i]);
+        image_cache[i] = NULL;
+    }
+    num_cached = 0;
+}
+
+static void image_cache_add(void)
+{
+    void *entry;
+
+    if (num_cached >= CACHE_MAX_ENTRIES) {
+        return;
+    }
+    entry = lv_mem_alloc(cache_entry_size);
+    if (entry) {
+        image_cache[num_cached++] = entry;
+    }
+}
+
+// The check runs on the system workqueue, give it the CPU so shedding is
+// done before the next allocation, as on the watch where LVGL shares it.
+static void check_pressure(void)
+{
+    zsw_mem_pressure_check();
+    k_msleep(1);
+}
+
+static void *alloc_or_report(const char *what, size_t size)
+{
+    void *buf = lv_mem_alloc(size);
+
+    if (buf == NULL) {
+        zsw_mem_pressure_report_alloc_failure(what, size);
+        k_msleep(1);
+    }
+
+    return buf;
+}
+
+// Same order as the watch: the app starts and draws its images, the app
+// manager checks the pressure, then a notification popup opens on top.
+static void run_app_with_notification(uint32_t cycle)
+{
+    lv_obj_t *root;
+    lv_obj_t *popup;
+    lv_obj_t *label;
+    void *app_buf;
+    void *body;
+
+    root = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(root, LV_PCT(100), LV_PCT(100));
+    for (int i = 0; i < NUM_LABELS; i++) {
+        label = lv_label_create(root);
+        lv_label_set_text_fmt(label, "App %u label %d", cycle, i);
+    }
+    app_buf = alloc_or_report("app", app_buf_size);
+    image_cache_add();
+    lv_refr_now(NULL);
+    check_pressure();
+
+    popup = lv_obj_create(lv_scr_act());
+    label = lv_label_create(popup);
+    lv_label_set_text_fmt(label, "Notification %u", cycle);
+    body = alloc_or_report("notification", notification_buf_size);
+    lv_refr_now(NULL);
+    check_pressure();
+
+    lv_mem_free(body);
+    lv_obj_del(popup);
+    lv_mem_free(app_buf);
+    lv_obj_del(root);
+    zsw_ui_mem_release_and_sample();
+}
+
+static void *mem_pressure_setup(void)
+{
+    lv_mem_monitor_t mon;
+
+    zassert_ok(zsw_mem_pressure_register(&image_cache_handler));
+
+    lv_mem_monitor(&mon);
+    cache_entry_size = mon.free_biggest_size * CACHE_ENTRY_TENTHS / 10;
+    app_buf_size = mon.free_biggest_size * APP_BUF_TENTHS / 10;
+    notification_buf_size = mon.free_biggest_size / NOTIFICATION_BUF_DIV;
+
+    return NULL;
+}
+
+ZTEST(mem_pressure, test_app_and_notification_churn)
+{
+    zsw_mem_pressure_stats_t stats;
+    zsw_ui_mem_stats_t ui_stats;
+
+    for (uint32_t cycle = 0; cycle < NUM_CYCLES; cycle++) {
+        run_app_with_notification(cycle);
+    }
+
+    zsw_mem_pressure_get_stats(&stats);
+    zsw_ui_mem_get_stats(&ui_stats);
+    TC_PRINT("Shedding %s: %u allocation failures, max level %d, %u sheds (%u of the image cache)\n",
+             IS_ENABLED(CONFIG_ZSW_MEM_PRESSURE_SHED) ? "on" : "off", stats.num_alloc_failures, stats.max_level,
+             stats.num_sheds, image_cache_handler.num_sheds);
+    TC_PRINT("Lowest LVGL largest free block %u%%, %u bytes after app close\n", stats.min_lvgl_free_percent,
+             ui_stats.min_largest_free_bytes);
+
+    zassert_true(stats.max_level > ZSW_MEM_PRESSURE_NONE, "The run never got under pressure");
+    if (IS_ENABLED(CONFIG_ZSW_MEM_PRESSURE_SHED)) {
+        zassert_true(image_cache_handler.num_sheds > 0);
+        zassert_equal(stats.num_alloc_failures, 0, "%u allocations failed with shedding",
+                      stats.num_alloc_failures);
+    } else {
+        zassert_equal(stats.num_sheds, 0);
+        // The baseline must fail, or the run does not show what shedding is for.
+        zassert_true(stats.num_alloc_failures > 0, "No allocation failed without shedding");
+    }
+}
+
+ZTEST_SUITE(mem_pressure, NULL, mem_pressure_setup, NULL, NULL, NULL);
@@ -0,0 +1,220 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <lvgl.h>
+
+#include "ui/utils/zsw_ui_mem.h"
+#include "managers/zsw_mem_pressure.h"
+
+#define NUM_CYCLES              10000
+#define INTERVAL_CYCLES         1000
+#define NUM_INTERVALS           (NUM_CYCLES / INTERVAL_CYCLES)
+
+#define MAX_LABELS              12
+#define MAX_APP_BUFS            4
+#define MAX_KEPT_BUFS           3
+#define KEPT_BUF_INTERVAL       7 // A buffer outliving the app is allocated every this many cycles.
+#define KEPT_BUF_LIFETIME       3 // And freed after this many cycles.
+
+// Bytes the pool may lose between intervals without being called a leak, covers
+// the allocator overhead of the kept buffers that is not in kept_bytes.
+#define LEAK_TOLERANCE_BYTES    128
+// How much worse the smallest largest free block may get than in the first interval, in percent.
+#define LARGEST_FREE_TOLERANCE_PCT  5
+// How many percentage points the worst fragmentation may grow over the first interval.
+#define FRAG_TOLERANCE_PCT      5
+
+typedef struct kept_buf_t {
+    void *buf;
+    size_t size;
+    uint32_t free_at_cycle;
+} kept_buf_t;
+
+// Worst values sampled after each app close in one interval of INTERVAL_CYCLES.
+typedef struct interval_t {
+    uint32_t min_largest_free_bytes;
+    uint8_t max_frag_pct;
+    uint32_t free_plus_kept_bytes; // At the end of the interval, with the kept buffers counted as free.
+} interval_t;
+
+static kept_buf_t kept_bufs[MAX_KEPT_BUFS];
+static size_t kept_bytes;
+static interval_t intervals[NUM_INTERVALS];
+static uint32_t rand_state;
+static uint32_t num_alloc_failures;
+
+// The real handler registry is not part of this test, zsw_ui_mem only registers itself.
+int zsw_mem_pressure_register(zsw_mem_pressure_handler_t *handler)
+{
+    return 0;
+}
+
+// Fixed seed so every run churns the pool the same way.
+static uint32_t next_rand(uint32_t min, uint32_t max)
+{
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+
+    return min + rand_state % (max - min + 1);
+}
+
+static void *alloc_or_count(size_t size)
+{
+    void *buf = lv_mem_alloc(size);
+
+    if (buf == NULL) {
+        num_alloc_failures++;
+    }
+
+    return buf;
+}
+
+// Long lived allocations, like a notification, pinned between app allocations.
+static void update_kept_bufs(uint32_t cycle)
+{
+    for (int i = 0; i < MAX_KEPT_BUFS; i++) {
+        if (kept_bufs[i].buf && cycle >= kept_bufs[i].free_at_cycle) {
+            lv_mem_free(kept_bufs[i].buf);
+            kept_bufs[i].buf = NULL;
+            kept_bytes -= kept_bufs[i].size;
+        }
+    }
+
+    if ((cycle % KEPT_BUF_INTERVAL) != 0) {
+        return;
+    }
+
+    for (int i = 0; i < MAX_KEPT_BUFS; i++) {
+        if (kept_bufs[i].buf == NULL) {
+            kept_bufs[i].size = next_rand(32, 512);
+            kept_bufs[i].buf = alloc_or_count(kept_bufs[i].size);
+            kept_bufs[i].free_at_cycle = cycle + KEPT_BUF_LIFETIME;
+            if (kept_bufs[i].buf) {
+                kept_bytes += kept_bufs[i].size;
+            }
+            break;
+        }
+    }
+}
+
+// Open an app of random size, draw it and close it like the app manager does.
+static void run_app_cycle(void)
+{
+    lv_obj_t *root;
+    lv_obj_t *label;
+    void *app_bufs[MAX_APP_BUFS] = { 0 };
+    void *scratch;
+    int num_labels = next_rand(1, MAX_LABELS);
+    int num_app_bufs = next_rand(0, MAX_APP_BUFS);
+
+    root = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(root, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(root, lv_color_hex(next_rand(0, 0xFFFFFF)), 0);
+
+    for (int i = 0; i < num_labels; i++) {
+        label = lv_label_create(root);
+        lv_label_set_text_fmt(label, "%0*d", (int)next_rand(1, 48), i);
+        lv_obj_set_pos(label, next_rand(0, 200), next_rand(0, 220));
+    }
+
+    for (int i = 0; i < num_app_bufs; i++) {
+        app_bufs[i] = alloc_or_count(next_rand(64, 2048));
+    }
+
+    // Scratch buffers are cached by LVGL after release.
+    scratch = lv_mem_buf_get(next_rand(256, 2048));
+    if (scratch) {
+        lv_mem_buf_release(scratch);
+    } else {
+        num_alloc_failures++;
+    }
+
+    lv_refr_now(NULL);
+
+    for (int i = 0; i < num_app_bufs; i++) {
+        lv_mem_free(app_bufs[i]);
+    }
+    lv_obj_del(root);
+    zsw_ui_mem_release_and_sample();
+}
+
+static void *ui_mem_setup(void)
+{
+    rand_state = 0x5A5A1234;
+
+    return NULL;
+}
+
+ZTEST(ui_mem, test_app_churn_trend)
+{
+    zsw_ui_mem_stats_t stats;
+    interval_t *interval;
+    interval_t *first = &intervals[0];
+    uint32_t min_largest_free_bytes = UINT32_MAX;
+    uint8_t max_frag_pct = 0;
+
+    for (uint32_t cycle = 0; cycle < NUM_CYCLES; cycle++) {
+        interval = &intervals[cycle / INTERVAL_CYCLES];
+        if ((cycle % INTERVAL_CYCLES) == 0) {
+            interval->min_largest_free_bytes = UINT32_MAX;
+        }
+
+        // Sampled by run_app_cycle while the kept buffers are still allocated.
+        update_kept_bufs(cycle);
+        run_app_cycle();
+        zsw_ui_mem_get_stats(&stats);
+
+        interval->min_largest_free_bytes = MIN(interval->min_largest_free_bytes, stats.largest_free_bytes);
+        interval->max_frag_pct = MAX(interval->max_frag_pct, stats.frag_pct);
+        interval->free_plus_kept_bytes = stats.free_bytes + kept_bytes;
+    }
+
+    TC_PRINT("cycles        min largest free  max frag  free + kept\n");
+    for (int i = 0; i < NUM_INTERVALS; i++) {
+        TC_PRINT("%5d - %5d  %16u  %7u%%  %11u\n", i * INTERVAL_CYCLES, (i + 1) * INTERVAL_CYCLES - 1,
+                 intervals[i].min_largest_free_bytes, intervals[i].max_frag_pct, intervals[i].free_plus_kept_bytes);
+        min_largest_free_bytes = MIN(min_largest_free_bytes, intervals[i].min_largest_free_bytes);
+        max_frag_pct = MAX(max_frag_pct, intervals[i].max_frag_pct);
+    }
+
+    zsw_ui_mem_get_stats(&stats);
+    zassert_equal(num_alloc_failures, 0, "%u allocations failed", num_alloc_failures);
+    zassert_equal(stats.num_samples, NUM_CYCLES);
+    // The since boot worst values of zsw_ui_mem must agree with what the test saw.
+    zassert_equal(stats.min_largest_free_bytes, min_largest_free_bytes);
+    zassert_equal(stats.max_frag_pct, max_frag_pct);
+
+    // The first interval is the reference, LVGL allocates some state lazily on first use.
+    for (int i = 1; i < NUM_INTERVALS; i++) {
+        zassert_true(intervals[i].free_plus_kept_bytes + LEAK_TOLERANCE_BYTES >= first->free_plus_kept_bytes,
+                     "Leaked %d bytes by cycle %d", first->free_plus_kept_bytes - intervals[i].free_plus_kept_bytes,
+                     (i + 1) * INTERVAL_CYCLES);
+        zassert_true(intervals[i].min_largest_free_bytes * 100 >=
+                     first->min_largest_free_bytes * (100 - LARGEST_FREE_TOLERANCE_PCT),
+                     "Smallest largest free block went from %u to %u bytes in cycles %d - %d",
+                     first->min_largest_free_bytes, intervals[i].min_largest_free_bytes, i * INTERVAL_CYCLES,
+                     (i + 1) * INTERVAL_CYCLES - 1);
+        zassert_true(intervals[i].max_frag_pct <= first->max_frag_pct + FRAG_TOLERANCE_PCT,
+                     "Worst fragmentation went from %u%% to %u%% in cycles %d - %d", first->max_frag_pct,
+                     intervals[i].max_frag_pct, i * INTERVAL_CYCLES, (i + 1) * INTERVAL_CYCLES - 1);
+    }
+}
+
+ZTEST_SUITE(ui_mem, NULL, ui_mem_setup, NULL, NULL, NULL);
@@ -0,0 +1,97 @@
+/*
+ * This file is part of ZSWatch project <https://github.com/jakkra/ZSWatch/>.
+ * Copyright (c) 2023 Jakob Krantz.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <lvgl.h>
+
+#include "applications/watchface/watchface_app.h"
+#include "ui/utils/zsw_ui_render_stats.h"
+
+#define MAX_WATCHFACES      2
+// Just over the render stats report interval, so render time gets computed.
+#define RUN_SECONDS         61
+
+static watchface_ui_api_t *watchfaces[MAX_WATCHFACES];
+static int num_watchfaces;
+
+// Normally implemented by watchface_app, both watchfaces register here on boot.
+void watchface_app_register_ui(watchface_ui_api_t *ui)
+{
+    __ASSERT_NO_MSG(num_watchfaces < MAX_WATCHFACES);
+    watchfaces[num_watchfaces++] = ui;
+}
+
+static void evt_cb(watchface_app_evt_t evt)
+{
+}
+
+// Same update pattern as watchface_app: time every second, the rest less often.
+static void run_watchface(watchface_ui_api_t *ui, zsw_ui_render_stats_t *stats)
+{
+    ui->show(evt_cb);
+    ui->set_date(3, 18);
+    ui->set_ble_connected(true);
+    ui->set_weather(12, 500);
+    ui->set_num_notifcations(2);
+
+    for (int s = 0; s <= RUN_SECONDS; s++) {
+        ui->set_time(10, 8 + s / 60, s % 60);
+        if ((s % 10) == 0) {
+            ui->set_step(1000 + s);
+            ui->set_battery_percent(80 - s / 30, 3900);
+            ui->set_watch_env_sensors(22, 40 + s % 3, 101300);
+        }
+        lv_refr_now(NULL);
+        k_msleep(1000);
+    }
+
+    zsw_ui_render_stats_get(stats);
+    ui->remove();
+    lv_refr_now(NULL);
+}
+
+ZTEST(watchface_render, test_digital_vs_drawn)
+{
+    zsw_ui_render_stats_t stats[MAX_WATCHFACES];
+    zsw_ui_render_stats_t *digital = NULL;
+    zsw_ui_render_stats_t *drawn = NULL;
+
+    zassert_equal(num_watchfaces, MAX_WATCHFACES);
+
+    for (int i = 0; i < num_watchfaces; i++) {
+        run_watchface(watchfaces[i], &stats[i]);
+        TC_PRINT("%-18s %6u bytes LVGL pool, %6u us/s render, %u draws\n", stats[i].name, stats[i].pool_used_bytes,
+                 stats[i].render_time_us_per_s, stats[i].num_draws);
+        zassert_not_null(stats[i].name);
+        zassert_true(stats[i].num_draws > 0, "%s was never drawn", stats[i].name);
+        if (strcmp(stats[i].name, "digital watchface") == 0) {
+            digital = &stats[i];
+        } else if (strcmp(stats[i].name, "drawn watchface") == 0) {
+            drawn = &stats[i];
+        }
+    }
+
+    zassert_not_null(digital);
+    zassert_not_null(drawn);
+    // The point of the drawn variant, one object instead of one per arc, label and icon.
+    zassert_true(drawn->pool_used_bytes < digital->pool_used_bytes, "Drawn uses %u bytes, digital %u bytes",
+                 drawn->pool_used_bytes, digital->pool_used_bytes);
+}
+
+ZTEST_SUITE(watchface_render, NULL, NULL, NULL, NULL, NULL);